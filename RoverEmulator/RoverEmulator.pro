@@ -0,0 +1,19 @@
+QT       = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# posix_openpt and friends, the emulator is a Linux/macOS tool
+!unix: error("RoverEmulator needs a Unix pseudo terminal")
+
+# The frame encoder is shared with the dashboard so both sides always agree
+INCLUDEPATH += ../UserRemoteControl
+
+SOURCES += \
+    ../UserRemoteControl/telemetryprotocol.cpp \
+    main.cpp \
+    roveremulator.cpp
+
+HEADERS += \
+    ../UserRemoteControl/telemetryprotocol.h \
+    roveremulator.h
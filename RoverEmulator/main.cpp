@@ -0,0 +1,49 @@
+#include "roveremulator.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <cstdio>
+
+// Stand-in for the rover on a pseudo terminal, e.g.
+//   RoverEmulator --rate 10000 --auto --link /tmp/rover
+//   UserRemoteControl --transport pty:/tmp/rover
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Emulates autonomousroverdashboard.ino on a pseudo terminal.");
+    parser.addHelpOption();
+    QCommandLineOption rateOption("rate", "Firmware loop iterations per second (default 20).", "hz", "20");
+    QCommandLineOption batteryOption("battery-every", "Send a battery frame every <n> loops (default 1).", "n", "1");
+    QCommandLineOption asciiOption("ascii", "Speak the ASCII line protocol instead of binary frames.");
+    QCommandLineOption autoOption("auto", "Start in AUTO mode, sweeping the servo.");
+    QCommandLineOption noiseOption("noise", "Echo noise in cm (default 1).", "cm", "1");
+    QCommandLineOption seedOption("seed", "Random seed (default 1).", "n", "1");
+    QCommandLineOption linkOption("link", "Create a symlink to the pty at <path>.", "path");
+    QCommandLineOption durationOption("duration", "Exit after <s> seconds (default: run forever).", "s", "0");
+    parser.addOptions({ rateOption, batteryOption, asciiOption, autoOption, noiseOption,
+                        seedOption, linkOption, durationOption });
+    parser.process(a);
+
+    RoverEmulator::Options options;
+    options.rate = qMax(1.0, parser.value(rateOption).toDouble());
+    options.batteryEvery = qMax(1, parser.value(batteryOption).toInt());
+    options.binary = !parser.isSet(asciiOption);
+    options.autoMode = parser.isSet(autoOption);
+    options.noise = qMax(0.0, parser.value(noiseOption).toDouble());
+    options.seed = parser.value(seedOption).toUInt();
+    options.link = parser.value(linkOption);
+
+    RoverEmulator emulator(options);
+    if (!emulator.open()) {
+        fprintf(stderr, "Could not create a pty: %s\n", qPrintable(emulator.errorString()));
+        return 1;
+    }
+    printf("pty:%s\n", qPrintable(options.link.isEmpty() ? emulator.slavePath() : options.link));
+    fflush(stdout);
+
+    int result = emulator.run(parser.value(durationOption).toDouble());
+    fprintf(stderr, "%llu loops, %llu bytes dropped\n",
+            (unsigned long long)emulator.loops(), (unsigned long long)emulator.droppedBytes());
+    return result;
+}
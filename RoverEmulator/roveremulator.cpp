@@ -0,0 +1,373 @@
+#include "roveremulator.h"
+#include <QFile>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+// Unsent output beyond this is dropped, like loop iterations that would have
+// blocked on a full UART buffer
+const int MaxPending = 256 * 1024;
+
+const float Pi = 3.14159265f;
+const float MaxRange = 400.0f;       // cm, HC-SR04 limit
+const float NoEcho = 510.0f;         // cm, firmware reports echoTimeout (30 ms) * 0.034 / 2
+const quint32 LaserOnTime = 2000000;  // us, firmware: millis() - laserStartTime >= 2000
+const quint32 LaserPause = 1000000;   // us, firmware: millis() - laserStopTime >= 1000
+const int SerialBufferSize = 64;      // HardwareSerial receive buffer, the rest is lost
+
+bool reached(quint32 now, quint32 deadline) {
+    return qint32(now - deadline) >= 0;
+}
+
+void appendFloat(QByteArray &out, float value) {
+    // Serial.print(float) prints two decimals
+    char text[32];
+    int length = snprintf(text, sizeof(text), "%.2f", value);
+    out.append(text, length);
+}
+
+}
+
+RoverEmulator::RoverEmulator(const Options &options)
+    : options(options)
+    , master(-1)
+    , slave(-1)
+    , servoSetting(0)
+    , servoIncreasing(true)
+    , autoMode(options.autoMode)
+    , laserActive(false)
+    , servoStopped(false)
+    , hostLaser(false)
+    , laserStartTime(0)
+    , laserStopTime(0)
+    , now(0)
+    , commandLength(0)
+    , random(options.seed)
+    , echoNoise(0.0f, float(options.noise))
+    , loopCount(0)
+    , dropped(0)
+{
+    memset(sequences, 0, sizeof(sequences));
+}
+
+RoverEmulator::~RoverEmulator() {
+    if (!options.link.isEmpty()) {
+        QFile::remove(options.link);
+    }
+    if (slave >= 0) {
+        ::close(slave);
+    }
+    if (master >= 0) {
+        ::close(master);
+    }
+}
+
+bool RoverEmulator::open() {
+    master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        error = QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+    slaveName = QString::fromLocal8Bit(ptsname(master));
+
+    // Raw bytes both ways, the dashboard sees exactly what a UART would carry
+    termios tio;
+    if (tcgetattr(master, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(master, TCSANOW, &tio);
+    }
+
+    // Holding the slave open keeps the master readable and writable while
+    // the dashboard connects and disconnects
+    slave = ::open(QFile::encodeName(slaveName).constData(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (!options.link.isEmpty()) {
+        QFile::remove(options.link);
+        if (!QFile::link(slaveName, options.link)) {
+            error = QString("Could not link %1 to %2").arg(options.link, slaveName);
+            return false;
+        }
+    }
+
+    // setup() prints these before anything else
+    pending.append("Radar and Battery Monitor\r\nINA219 chip found\r\n");
+    return true;
+}
+
+int RoverEmulator::run(double seconds) {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+    const double period = 1e6 / options.rate;
+    const quint64 maxBatch = quint64(qMax(1.0, options.rate / 100));
+    quint64 next = 0;
+    char input[256];
+
+    for (;;) {
+        double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        if (seconds > 0 && elapsed >= seconds * 1e6) {
+            break;
+        }
+
+        // Catch up on every loop that is due, but never spiral on a slow host
+        quint64 due = quint64(elapsed / period) + 1;
+        for (quint64 batch = 0; next < due && batch < maxBatch; ++batch, ++next) {
+            QByteArray out;
+            step(quint32(quint64(next * period)), out);
+            if (pending.size() + out.size() > MaxPending) {
+                dropped += quint64(out.size());
+            } else {
+                pending.append(out);
+            }
+        }
+        if (next < due) {
+            next = due;
+        }
+        flush();
+
+        // Sleep until the next loop is due or a command arrives
+        int timeout = qMax(0, int((next * period - elapsed) / 1000));
+        pollfd fds[1] = { { master, short(POLLIN | (pending.isEmpty() ? 0 : POLLOUT)), 0 } };
+        if (poll(fds, 1, timeout) > 0 && (fds[0].revents & POLLIN)) {
+            ssize_t count = ::read(master, input, sizeof(input));
+            if (count > 0) {
+                receive(input, int(count));
+            }
+        }
+    }
+    flush();
+    return 0;
+}
+
+void RoverEmulator::step(quint32 micros, QByteArray &out) {
+    now = micros;
+    ++loopCount;
+
+    // getDistance(), readSerialCommand(), outputDistance(). Commands that came
+    // in during the previous loop's pulseIn() and delay(50) are acked here
+    float distance = measureDistance(micros);
+    readSerialCommand(out);
+    Telemetry::Message msg;
+    msg.id = Telemetry::RadarMessage;
+    msg.radar.angle = float(servoSetting);
+    msg.radar.distance = distance;
+    msg.radar.deviceTime = micros;
+    sendFrame(msg, out);
+
+    if (!hostLaser && distance < 50 && !laserActive && !servoStopped) {
+        activateLaser(micros);
+        msg.id = Telemetry::LaserMessage;
+        msg.laser = Telemetry::LaserActivated;
+        sendFrame(msg, out);
+    } else if (laserActive && reached(micros, laserStartTime + LaserOnTime)) {
+        deactivateLaser(micros);
+        msg.id = Telemetry::LaserMessage;
+        msg.laser = Telemetry::LaserDeactivated;
+        sendFrame(msg, out);
+    } else if (!laserActive && servoStopped && reached(micros, laserStopTime + LaserPause)) {
+        servoStopped = false;
+    }
+
+    if (!laserActive && !servoStopped && autoMode) {
+        updateServoAuto();
+    }
+
+    if (loopCount % quint64(qMax(1, options.batteryEvery)) == 0) {
+        msg.id = Telemetry::BatteryMessage;
+        readBattery(micros, msg.battery);
+        sendFrame(msg, out);
+    }
+}
+
+void RoverEmulator::receive(const char *data, int size) {
+    // Bytes past a full buffer are lost, as on the board
+    serialInput.append(data, qMin(size, qMax(0, SerialBufferSize - int(serialInput.size()))));
+}
+
+void RoverEmulator::readSerialCommand(QByteArray &out) {
+    // Same line assembly as the sketch
+    for (int i = 0; i < serialInput.size(); ++i) {
+        char c = serialInput[i];
+        if (c == '\n') {
+            commandBuffer[commandLength] = '\0';
+            handleCommand(commandBuffer, out);
+            commandLength = 0;
+        } else if (commandLength < int(sizeof(commandBuffer)) - 1) {
+            commandBuffer[commandLength++] = c;
+        }
+    }
+    serialInput.clear();
+}
+
+void RoverEmulator::handleCommand(char *line, QByteArray &out) {
+    long seq = -1;
+    char *colon = strchr(line, ':');
+    if (colon) {
+        *colon = '\0';
+        seq = atol(line);
+        line = colon + 1;
+    }
+
+    QByteArray command = QByteArray(line).trimmed();
+    if (command == "AUTO") {
+        autoMode = true;
+    } else if (command == "MANUAL") {
+        autoMode = false;
+    } else if (command == "LASER_ON") {
+        activateLaser(now);
+    } else if (command == "LASER_OFF") {
+        deactivateLaser(now);
+    } else if (command == "HOST_LASER") {
+        hostLaser = true;
+    } else if (command == "DEVICE_LASER") {
+        hostLaser = false;
+    } else {
+        int angle = command.toInt();
+        if (angle >= 0 && angle <= 180 && !autoMode) {
+            servoSetting = angle;
+        }
+    }
+
+    if (seq >= 0) {
+        Telemetry::Message msg;
+        msg.id = Telemetry::AckMessage;
+        msg.ack = quint16(seq);
+        sendFrame(msg, out);
+    }
+}
+
+void RoverEmulator::activateLaser(quint32 micros) {
+    laserActive = true;
+    servoStopped = true;
+    laserStartTime = micros;
+}
+
+void RoverEmulator::deactivateLaser(quint32 micros) {
+    laserActive = false;
+    servoStopped = true;
+    laserStopTime = micros;
+}
+
+void RoverEmulator::updateServoAuto() {
+    if (servoIncreasing) {
+        servoSetting += 2;
+        if (servoSetting >= 180) {
+            servoSetting = 180;
+            servoIncreasing = false;
+        }
+    } else {
+        servoSetting -= 2;
+        if (servoSetting <= 0) {
+            servoSetting = 0;
+            servoIncreasing = true;
+        }
+    }
+}
+
+float RoverEmulator::measureDistance(quint32 micros) {
+    float angle = servoSetting * Pi / 180.0f;
+
+    // A 6 m x 3 m room with the rover in the middle of the long wall
+    float range = MaxRange;
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+    if (s > 1e-3f) {
+        range = qMin(range, 300.0f / s);
+    }
+    if (std::fabs(c) > 1e-3f) {
+        range = qMin(range, 300.0f / std::fabs(c));
+    }
+
+    // Someone walking across the room on a 20 s cycle, 40 to 150 cm away
+    float phase = 2 * Pi * float(micros % 20000000u) / 20e6f;
+    float targetAngle = (90.0f + 60.0f * std::sin(phase)) * Pi / 180.0f;
+    float targetRange = 95.0f + 55.0f * std::cos(2 * phase);
+    float bearing = std::fabs(angle - targetAngle);
+    if (bearing < 8.0f * Pi / 180.0f) {
+        range = qMin(range, targetRange);
+    }
+
+    // Nothing in range, pulseIn() times out and the firmware sends the timeout distance
+    if (range >= MaxRange) {
+        return NoEcho;
+    }
+    return qBound(2.0f, range + echoNoise(random), MaxRange);
+}
+
+void RoverEmulator::readBattery(quint32 micros, Telemetry::BatterySample &sample) {
+    // 2S Li-ion draining about 0.1 V per 10 minutes, servo and laser load on top
+    float minutes = float(micros) / 60e6f;
+    sample.busVoltage = 8.2f - 0.01f * minutes;
+    sample.current = 350.0f + (laserActive ? 30.0f : 0.0f) + (autoMode ? 120.0f : 0.0f) + echoNoise(random) * 5.0f;
+    sample.shuntVoltage = sample.current * 0.1f;  // 0.1 ohm shunt
+    sample.loadVoltage = sample.busVoltage + sample.shuntVoltage / 1000.0f;
+    sample.power = sample.busVoltage * sample.current;
+    sample.deviceTime = micros;
+}
+
+void RoverEmulator::sendFrame(Telemetry::Message &msg, QByteArray &out) {
+    msg.hasDeviceTime = msg.id == Telemetry::RadarMessage || msg.id == Telemetry::BatteryMessage;
+    msg.hasSequence = true;
+    msg.sequence = sequences[msg.id]++;
+
+    if (options.binary) {
+        out.append(Telemetry::encodeFrame(msg));
+        return;
+    }
+
+    // Serial.println() ends lines with \r\n
+    switch (msg.id) {
+    case Telemetry::RadarMessage:
+        out.append(QByteArray::number(qRound(msg.radar.angle)));
+        out.append(',');
+        appendFloat(out, msg.radar.distance);
+        out.append(',');
+        out.append(QByteArray::number(msg.radar.deviceTime));
+        out.append(',');
+        out.append(QByteArray::number(msg.sequence));
+        break;
+    case Telemetry::BatteryMessage:
+        out.append("B,");
+        appendFloat(out, msg.battery.busVoltage);
+        out.append(',');
+        appendFloat(out, msg.battery.shuntVoltage);
+        out.append(',');
+        appendFloat(out, msg.battery.loadVoltage);
+        out.append(',');
+        appendFloat(out, msg.battery.current);
+        out.append(',');
+        appendFloat(out, msg.battery.power);
+        out.append(',');
+        out.append(QByteArray::number(msg.battery.deviceTime));
+        out.append(',');
+        out.append(QByteArray::number(msg.sequence));
+        break;
+    case Telemetry::LaserMessage:
+        out.append(msg.laser == Telemetry::LaserActivated ? "LASER_ACTIVATED" : "LASER_DEACTIVATED");
+        break;
+    case Telemetry::AckMessage:
+        out.append("ACK,");
+        out.append(QByteArray::number(msg.ack));
+        break;
+    }
+    out.append("\r\n");
+}
+
+void RoverEmulator::flush() {
+    while (!pending.isEmpty()) {
+        ssize_t count = ::write(master, pending.constData(), size_t(pending.size()));
+        if (count <= 0) {
+            // EAGAIN: the dashboard is not keeping up, try again next loop
+            return;
+        }
+        pending.remove(0, int(count));
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef ROVEREMULATOR_H
+#define ROVEREMULATOR_H
+
+#include <QByteArray>
+#include <QString>
+#include <random>
+#include "telemetryprotocol.h"
+
+// Host-side stand-in for autonomousroverdashboard.ino on a pseudo terminal.
+// It runs the same loop as the firmware: ping, commands, distance output,
+// laser state machine, servo sweep, battery frame. The loop rate is free, from
+// the board's ~20 Hz up to well past 10 kHz, and the HC-SR04 and INA219 are
+// replaced by a simulated room with one moving target.
+//
+// Device time is virtual: loop k runs at exactly k / rate seconds, so the
+// output is the same on every run no matter how busy the host is.
+class RoverEmulator
+{
+public:
+    struct Options {
+        double rate = 20;         // loop iterations per second
+        int batteryEvery = 1;     // battery frame every n loops, 1 like the firmware
+        bool binary = true;       // TELEMETRY_BINARY
+        bool autoMode = false;    // start sweeping without an AUTO command
+        double noise = 1.0;       // cm, standard deviation of the echo
+        unsigned seed = 1;
+        QString link;             // optional symlink to the pty
+    };
+
+    explicit RoverEmulator(const Options &options);
+    ~RoverEmulator();
+
+    // Creates the pty, returns false with errorString() set on failure
+    bool open();
+    QString slavePath() const { return slaveName; }
+    QString errorString() const { return error; }
+
+    // Serves the pty until seconds have passed (0 = forever)
+    int run(double seconds = 0);
+
+    // One iteration of the firmware loop at device time micros, appends what
+    // the board would have written to out
+    void step(quint32 micros, QByteArray &out);
+
+    // Feeds bytes as if they came in over the serial line. Like the UART they
+    // wait in a 64 byte receive buffer until the next loop reads them, so
+    // commands are applied and acked no earlier than the next step()
+    void receive(const char *data, int size);
+
+    quint64 loops() const { return loopCount; }
+    quint64 droppedBytes() const { return dropped; }
+
+private:
+    float measureDistance(quint32 micros);
+    void readSerialCommand(QByteArray &out);
+    void readBattery(quint32 micros, Telemetry::BatterySample &sample);
+    void handleCommand(char *line, QByteArray &out);
+    void activateLaser(quint32 micros);
+    void deactivateLaser(quint32 micros);
+    void updateServoAuto();
+    void sendFrame(Telemetry::Message &msg, QByteArray &out);
+    void flush();
+
+    Options options;
+    QString error;
+    QString slaveName;
+    int master;
+    int slave;
+
+    // Firmware state, same names as the sketch
+    int servoSetting;
+    bool servoIncreasing;
+    bool autoMode;
+    bool laserActive;
+    bool servoStopped;
+    bool hostLaser;
+    quint32 laserStartTime;
+    quint32 laserStopTime;
+    quint32 now;  // device time of the current loop
+    quint16 sequences[Telemetry::AckMessage + 1];
+    QByteArray serialInput;
+    char commandBuffer[24];
+    int commandLength;
+
+    std::mt19937 random;
+    std::normal_distribution<float> echoNoise;
+    quint64 loopCount;
+    QByteArray pending;
+    quint64 dropped;
+};
+
+#endif // ROVEREMULATOR_H
@@ -1,4 +1,4 @@
-QT       += core gui serialport widgets
+QT       += core gui network serialport widgets
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,11 +9,60 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    batteryhistorymodel.cpp \
+    byteringbuffer.cpp \
+    clocksync.cpp \
+    cluttermodel.cpp \
+    commandchannel.cpp \
+    devicesession.cpp \
+    deviceworker.cpp \
+    frameprofiler.cpp \
+    linkstats.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    occupancygrid.cpp \
+    occupancygriditem.cpp \
+    phosphoritem.cpp \
+    pointclouditem.cpp \
+    ptytransport.cpp \
+    radarview.cpp \
+    replaytransport.cpp \
+    sampleparser.cpp \
+    serialtransport.cpp \
+    sweepcontouritem.cpp \
+    sweeptracker.cpp \
+    tcptransport.cpp \
+    telemetryprotocol.cpp \
+    transport.cpp
 
 HEADERS += \
-    mainwindow.h
+    batteryhistorymodel.h \
+    byteringbuffer.h \
+    clocksync.h \
+    cluttermodel.h \
+    commandchannel.h \
+    devicesession.h \
+    deviceworker.h \
+    frameprofiler.h \
+    linkstats.h \
+    mainwindow.h \
+    occupancygrid.h \
+    occupancygriditem.h \
+    phosphoritem.h \
+    pointclouditem.h \
+    polartransform.h \
+    ptytransport.h \
+    radarview.h \
+    replaytransport.h \
+    ringbuffer.h \
+    sampleparser.h \
+    serialtransport.h \
+    spscqueue.h \
+    sweepcontouritem.h \
+    sweeptracker.h \
+    tcptransport.h \
+    telemetryprotocol.h \
+    transport.h
 
 FORMS += \
     mainwindow.ui
@@ -22,6 +71,3 @@ FORMS += \
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    resources.qrc
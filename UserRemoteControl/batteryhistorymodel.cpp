@@ -0,0 +1,90 @@
+#include "batteryhistorymodel.h"
+#include <QDateTime>
+
+BatteryHistoryModel::BatteryHistoryModel(int capacity, QObject *parent)
+    : QAbstractTableModel(parent)
+    , samples(capacity)
+{
+}
+
+void BatteryHistoryModel::append(const Telemetry::BatterySample &sample) {
+    // The oldest row leaves at the bottom before the new one enters at the top
+    if (samples.isFull()) {
+        int last = samples.size() - 1;
+        beginRemoveRows(QModelIndex(), last, last);
+        samples.dropOldest();
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), 0, 0);
+    samples.append(sample);
+    endInsertRows();
+}
+
+void BatteryHistoryModel::clear() {
+    beginResetModel();
+    samples.clear();
+    endResetModel();
+}
+
+int BatteryHistoryModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : samples.size();
+}
+
+int BatteryHistoryModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant BatteryHistoryModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= samples.size()) {
+        return QVariant();
+    }
+    if (role == Qt::TextAlignmentRole) {
+        Qt::Alignment alignment = Qt::AlignRight | Qt::AlignVCenter;
+        if (index.column() == TimeColumn) {
+            alignment = Qt::AlignCenter;
+        }
+        return int(alignment);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    // Stamped when the device measured it
+    const Telemetry::BatterySample &s = samples.newest(index.row());
+    switch (index.column()) {
+    case TimeColumn:
+        return QDateTime::fromMSecsSinceEpoch(s.timestamp / 1000).toString("hh:mm:ss");
+    case BusVoltageColumn:
+        return QString::number(s.busVoltage, 'f', 2);
+    case ShuntVoltageColumn:
+        return QString::number(s.shuntVoltage, 'f', 2);
+    case LoadVoltageColumn:
+        return QString::number(s.loadVoltage, 'f', 2);
+    case CurrentColumn:
+        return QString::number(s.current, 'f', 2);
+    case PowerColumn:
+        return QString::number(s.power, 'f', 2);
+    }
+    return QVariant();
+}
+
+QVariant BatteryHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case TimeColumn:
+        return QString("Time");
+    case BusVoltageColumn:
+        return QString("Bus Voltage (V)");
+    case ShuntVoltageColumn:
+        return QString("Shunt Voltage (mV)");
+    case LoadVoltageColumn:
+        return QString("Load Voltage (V)");
+    case CurrentColumn:
+        return QString("Current (mA)");
+    case PowerColumn:
+        return QString("Power (mW)");
+    }
+    return QVariant();
+}
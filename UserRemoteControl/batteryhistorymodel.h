@@ -0,0 +1,42 @@
+#ifndef BATTERYHISTORYMODEL_H
+#define BATTERYHISTORYMODEL_H
+
+#include <QAbstractTableModel>
+#include "ringbuffer.h"
+#include "telemetryprotocol.h"
+
+// Battery readings over time for a QTableView, newest first. Samples live
+// as plain structs in a fixed-capacity ring and are only formatted when the
+// view asks for a visible cell, so the history can run to thousands of rows
+// and adding one costs O(1) whatever the size.
+class BatteryHistoryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        TimeColumn,
+        BusVoltageColumn,
+        ShuntVoltageColumn,
+        LoadVoltageColumn,
+        CurrentColumn,
+        PowerColumn,
+        ColumnCount
+    };
+
+    explicit BatteryHistoryModel(int capacity = 10000, QObject *parent = nullptr);
+
+    void append(const Telemetry::BatterySample &sample);
+    void clear();
+    const Telemetry::BatterySample &sample(int row) const { return samples.newest(row); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    RingBuffer<Telemetry::BatterySample> samples;
+};
+
+#endif // BATTERYHISTORYMODEL_H
@@ -0,0 +1,24 @@
+QT       = core testlib
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# Microbenchmarks for the ingest and render hot paths, run with e.g. -median 5
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../byteringbuffer.cpp \
+    ../sampleparser.cpp \
+    main.cpp \
+    polartransformbench.cpp \
+    ringbufferbench.cpp \
+    sampleparserbench.cpp
+
+HEADERS += \
+    ../byteringbuffer.h \
+    ../polartransform.h \
+    ../sampleparser.h \
+    ../telemetryprotocol.h \
+    polartransformbench.h \
+    ringbufferbench.h \
+    sampleparserbench.h
@@ -0,0 +1,21 @@
+#include "polartransformbench.h"
+#include "ringbufferbench.h"
+#include "sampleparserbench.h"
+#include <QCoreApplication>
+#include <QTest>
+
+// Runs every benchmark class in turn, e.g.
+//   bench -median 5
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    int status = 0;
+    RingBufferBench ringBuffer;
+    status |= QTest::qExec(&ringBuffer, argc, argv);
+    SampleParserBench sampleParser;
+    status |= QTest::qExec(&sampleParser, argc, argv);
+    PolarTransformBench polarTransform;
+    status |= QTest::qExec(&polarTransform, argc, argv);
+    return status;
+}
@@ -0,0 +1,65 @@
+#include "polartransformbench.h"
+#include "polartransform.h"
+#include <QTest>
+
+namespace {
+
+const QPointF Origin(505, 495);
+const float Distance = 243.0f;
+const float NeedleLength = 450.0f;
+
+// What MainWindow::updateDetectionPoint computed per sample before the tables
+void trigPoints(float angle, QPointF *points) {
+    float radAngle = qDegreesToRadians(angle);
+    points[0] = QPointF(Origin.x() + Distance * qCos(radAngle), Origin.y() - Distance * qSin(radAngle));
+    float up = radAngle + float(PolarTransform::NeedleHalfWidth);
+    float lo = radAngle - float(PolarTransform::NeedleHalfWidth);
+    points[1] = QPointF(NeedleLength * qCos(up) + Origin.x(), -NeedleLength * qSin(up) + Origin.y());
+    points[2] = QPointF(NeedleLength * qCos(lo) + Origin.x(), -NeedleLength * qSin(lo) + Origin.y());
+}
+
+void tablePoints(float angle, QPointF *points) {
+    points[0] = PolarTransform::toScene(Origin, angle, Distance);
+    points[1] = PolarTransform::toScene(Origin, PolarTransform::needleUpper(angle), NeedleLength);
+    points[2] = PolarTransform::toScene(Origin, PolarTransform::needleLower(angle), NeedleLength);
+}
+
+}
+
+void PolarTransformBench::trigFunctions() {
+    QPointF points[3];
+    qreal sum = 0;
+    QBENCHMARK {
+        for (int angle = 0; angle <= PolarTransform::MaxAngle; ++angle) {
+            trigPoints(float(angle), points);
+            sum += points[0].x() + points[1].y() + points[2].y();
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+void PolarTransformBench::trigTables() {
+    QPointF points[3];
+    qreal sum = 0;
+    QBENCHMARK {
+        for (int angle = 0; angle <= PolarTransform::MaxAngle; ++angle) {
+            tablePoints(float(angle), points);
+            sum += points[0].x() + points[1].y() + points[2].y();
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+void PolarTransformBench::tablesMatchTrig() {
+    QPointF expected[3];
+    QPointF actual[3];
+    for (int angle = 0; angle <= PolarTransform::MaxAngle; ++angle) {
+        trigPoints(float(angle), expected);
+        tablePoints(float(angle), actual);
+        for (int i = 0; i < 3; ++i) {
+            // Within a thousandth of a scene pixel
+            QVERIFY(qAbs(expected[i].x() - actual[i].x()) < 1e-3);
+            QVERIFY(qAbs(expected[i].y() - actual[i].y()) < 1e-3);
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef POLARTRANSFORMBENCH_H
+#define POLARTRANSFORMBENCH_H
+
+#include <QObject>
+
+// A detection point plus both needle edges for every servo angle: the
+// PolarTransform tables against the qCos/qSin calls they replaced
+class PolarTransformBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void trigFunctions();
+    void trigTables();
+    void tablesMatchTrig();
+};
+
+#endif // POLARTRANSFORMBENCH_H
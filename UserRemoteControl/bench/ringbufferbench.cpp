@@ -0,0 +1,83 @@
+#include "ringbufferbench.h"
+#include "byteringbuffer.h"
+#include <QTest>
+#include <cstring>
+
+namespace {
+
+// Radar lines as the firmware prints them, one burst as a single read() returns it
+QByteArray makeBurst(int lines) {
+    QByteArray burst;
+    for (int i = 0; i < lines; ++i) {
+        burst += QByteArray::number(i % 181) + ',' + QByteArray::number(20 + i % 380) + ','
+                 + QByteArray::number(quint32(i) * 50000u) + ',' + QByteArray::number(i & 0xffff) + '\n';
+    }
+    return burst;
+}
+
+void addBurstSizes() {
+    QTest::addColumn<int>("lines");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+}
+
+void RingBufferBench::byteArraySplit_data() {
+    addBurstSizes();
+}
+
+void RingBufferBench::byteArraySplit() {
+    QFETCH(int, lines);
+    const QByteArray burst = makeBurst(lines);
+
+    int found = 0;
+    QBENCHMARK {
+        QByteArray pending;
+        pending.append(burst);
+        found = 0;
+        while (pending.contains('\n')) {
+            int lineEnd = pending.indexOf('\n');
+            QByteArray line = pending.left(lineEnd);
+            pending = pending.mid(lineEnd + 1);
+            found += line.isEmpty() ? 0 : 1;
+        }
+    }
+    QCOMPARE(found, lines);
+}
+
+void RingBufferBench::ringBufferSplit_data() {
+    addBurstSizes();
+}
+
+void RingBufferBench::ringBufferSplit() {
+    QFETCH(int, lines);
+    const QByteArray burst = makeBurst(lines);
+
+    ByteRingBuffer ring;
+    int found = 0;
+    QBENCHMARK {
+        ring.clear();
+        found = 0;
+        // Same loop as DeviceWorker::readTransport, with memcpy standing in for read()
+        const char *src = burst.constData();
+        int remaining = int(burst.size());
+        while (remaining > 0) {
+            int room;
+            char *dst = ring.writePointer(&room);
+            int count = qMin(room, remaining);
+            memcpy(dst, src, count);
+            ring.commit(count);
+            src += count;
+            remaining -= count;
+
+            const char *record;
+            int size;
+            while (ring.takeRecord('\n', &record, &size)) {
+                found += size > 0 ? 1 : 0;
+            }
+        }
+    }
+    QCOMPARE(found, lines);
+}
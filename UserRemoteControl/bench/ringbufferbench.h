@@ -0,0 +1,19 @@
+#ifndef RINGBUFFERBENCH_H
+#define RINGBUFFERBENCH_H
+
+#include <QObject>
+
+// Splitting a burst of ASCII telemetry lines: ByteRingBuffer against the
+// QByteArray append/left/mid loop the readers used before it
+class RingBufferBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void byteArraySplit_data();
+    void byteArraySplit();
+    void ringBufferSplit_data();
+    void ringBufferSplit();
+};
+
+#endif // RINGBUFFERBENCH_H
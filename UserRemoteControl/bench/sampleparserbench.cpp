@@ -0,0 +1,50 @@
+#include "sampleparserbench.h"
+#include "sampleparser.h"
+#include <QStringList>
+#include <QTest>
+
+namespace {
+
+void addLines() {
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<int>("fields");
+    QTest::newRow("radar") << QByteArray("137,243.18,81234567,4711\r") << 4;
+    QTest::newRow("battery") << QByteArray("B,7.42,1.25,7.43,125.00,927.50,81234567,4712\r") << 8;
+}
+
+}
+
+void SampleParserBench::stringSplit_data() {
+    addLines();
+}
+
+void SampleParserBench::stringSplit() {
+    QFETCH(QByteArray, line);
+    QFETCH(int, fields);
+
+    float sum = 0;
+    QBENCHMARK {
+        QStringList parts = QString::fromUtf8(line).trimmed().split(',');
+        QCOMPARE(int(parts.size()), fields);
+        for (const QString &part : parts) {
+            sum += part.toFloat();
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void SampleParserBench::sampleParser_data() {
+    addLines();
+}
+
+void SampleParserBench::sampleParser() {
+    QFETCH(QByteArray, line);
+
+    Telemetry::Message msg;
+    bool parsed = false;
+    QBENCHMARK {
+        parsed = SampleParser::parseLine(line.constData(), line.constData() + line.size(), msg);
+    }
+    QVERIFY(parsed);
+    QVERIFY(msg.hasSequence);
+}
@@ -0,0 +1,19 @@
+#ifndef SAMPLEPARSERBENCH_H
+#define SAMPLEPARSERBENCH_H
+
+#include <QObject>
+
+// One ASCII telemetry line: SampleParser against the QString split/toFloat
+// path the dashboard used before it
+class SampleParserBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stringSplit_data();
+    void stringSplit();
+    void sampleParser_data();
+    void sampleParser();
+};
+
+#endif // SAMPLEPARSERBENCH_H
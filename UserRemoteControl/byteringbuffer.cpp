@@ -0,0 +1,80 @@
+#include "byteringbuffer.h"
+#include <cstring>
+
+ByteRingBuffer::ByteRingBuffer(int capacity)
+    : mask(0)
+    , head(0)
+    , tail(0)
+    , scan(0)
+{
+    // Power of two so positions can be masked instead of divided
+    int rounded = 16;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    storage = QByteArray(rounded, Qt::Uninitialized);
+    wrapped = QByteArray(rounded, Qt::Uninitialized);
+    mask = rounded - 1;
+}
+
+void ByteRingBuffer::clear() {
+    head = tail = scan = 0;
+}
+
+char *ByteRingBuffer::writePointer(int *room) {
+    if (size() == capacity()) {
+        clear();
+    }
+    int offset = int(tail & quint32(mask));
+    *room = qMin(capacity() - size(), capacity() - offset);
+    return storage.data() + offset;
+}
+
+void ByteRingBuffer::commit(int count) {
+    tail += quint32(count);
+}
+
+void ByteRingBuffer::append(const char *data, int size) {
+    while (size > 0) {
+        int room;
+        char *dst = writePointer(&room);
+        int count = qMin(room, size);
+        memcpy(dst, data, count);
+        commit(count);
+        data += count;
+        size -= count;
+    }
+}
+
+bool ByteRingBuffer::takeRecord(char delimiter, const char **data, int *size) {
+    const char *base = storage.constData();
+
+    // Only look at bytes that arrived since the last unsuccessful search
+    while (scan != tail) {
+        int offset = int(scan & quint32(mask));
+        int length = qMin(int(tail - scan), capacity() - offset);
+        const char *found = static_cast<const char *>(memchr(base + offset, delimiter, length));
+        if (!found) {
+            scan += quint32(length);
+            continue;
+        }
+
+        quint32 end = scan + quint32(found - (base + offset));
+        int start = int(head & quint32(mask));
+        int recordSize = int(end - head);
+
+        if (start + recordSize <= capacity()) {
+            *data = base + start;
+        } else {
+            int first = capacity() - start;
+            memcpy(wrapped.data(), base + start, first);
+            memcpy(wrapped.data() + first, base, recordSize - first);
+            *data = wrapped.constData();
+        }
+        *size = recordSize;
+
+        head = scan = end + 1;
+        return true;
+    }
+    return false;
+}
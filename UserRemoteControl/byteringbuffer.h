@@ -0,0 +1,42 @@
+#ifndef BYTERINGBUFFER_H
+#define BYTERINGBUFFER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Fixed-size byte ring for the serial ingest path. The port reads straight into
+// writePointer(), and takeRecord() hands out delimiter-terminated lines or frames
+// as views into the ring, so per-record cost does not depend on how much is
+// still buffered behind it.
+class ByteRingBuffer
+{
+public:
+    explicit ByteRingBuffer(int capacity = 4096);
+
+    int size() const { return int(tail - head); }
+    int capacity() const { return mask + 1; }
+    bool isEmpty() const { return head == tail; }
+    void clear();
+
+    // Contiguous free space for a direct read(). A full ring holds no complete
+    // record (the caller drains after every commit), so it is dropped to resync.
+    char *writePointer(int *room);
+    void commit(int count);
+
+    void append(const char *data, int size);
+
+    // Next record terminated by delimiter, without the delimiter. Points into the
+    // ring unless the record wraps around its end, and stays valid until the next
+    // call on the buffer.
+    bool takeRecord(char delimiter, const char **data, int *size);
+
+private:
+    QByteArray storage;
+    QByteArray wrapped;
+    int mask;
+    quint32 head;
+    quint32 tail;
+    quint32 scan;
+};
+
+#endif // BYTERINGBUFFER_H
@@ -0,0 +1,86 @@
+#include "clocksync.h"
+#include <limits>
+
+ClockSync::ClockSync() {
+    reset();
+}
+
+void ClockSync::reset() {
+    lastRaw = 0;
+    wraps = 0;
+    started = false;
+    windowStart = 0;
+    windowTime = 0;
+    windowMin = std::numeric_limits<qint64>::max();
+    count = 0;
+    next = 0;
+    intercept = 0;
+    slope = 0;
+    fitOrigin = 0;
+    fitted = false;
+    lastHost = std::numeric_limits<qint64>::min();
+}
+
+qint64 ClockSync::unwrap(quint32 deviceTime) {
+    if (started && deviceTime < lastRaw) {
+        quint32 back = lastRaw - deviceTime;
+        if (back > 0x80000000u) {
+            // micros() wraps every ~71 minutes
+            wraps += qint64(1) << 32;
+        } else if (back > quint32(WindowLength)) {
+            // Jumped back by more than reordering explains, the board restarted
+            reset();
+        } else {
+            return wraps + deviceTime;
+        }
+    }
+    started = true;
+    lastRaw = deviceTime;
+    return wraps + deviceTime;
+}
+
+qint64 ClockSync::toHost(quint32 deviceTime, qint64 receivedAt) {
+    qint64 t = unwrap(deviceTime);
+    qint64 delta = receivedAt - t;
+
+    if (windowMin == std::numeric_limits<qint64>::max()) {
+        windowStart = t;
+    } else if (t - windowStart >= WindowLength) {
+        closeWindow();
+        windowStart = t;
+    }
+    if (delta < windowMin) {
+        windowMin = delta;
+        windowTime = t;
+    }
+
+    qint64 estimate = fitted ? qint64(intercept + slope * double(t - fitOrigin)) : windowMin;
+
+    // Nothing is received before it is measured
+    lastHost = qMax(lastHost, qMin(t + estimate, receivedAt));
+    return lastHost;
+}
+
+void ClockSync::closeWindow() {
+    minTime[next] = windowTime;
+    minDelta[next] = windowMin;
+    next = (next + 1) % Windows;
+    count = qMin(count + 1, int(Windows));
+    windowMin = std::numeric_limits<qint64>::max();
+
+    // Fit relative to the newest minimum to keep the doubles well conditioned
+    fitOrigin = minTime[(next + Windows - 1) % Windows];
+    double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (int i = 0; i < count; ++i) {
+        double x = double(minTime[i] - fitOrigin);
+        double y = double(minDelta[i]);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+    double denominator = count * sumXX - sumX * sumX;
+    slope = denominator > 0 ? (count * sumXY - sumX * sumY) / denominator : 0;
+    intercept = (sumY - slope * sumX) / count;
+    fitted = true;
+}
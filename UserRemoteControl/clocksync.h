@@ -0,0 +1,56 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <QtGlobal>
+
+// Maps the firmware's micros() onto the host clock. Every sample gives
+// d = host receive time - device time, which is the clock offset plus a
+// transport delay that is never negative. The smallest d of each device
+// second is the sample that got through fastest, and a least-squares line
+// through the recent minima gives offset and drift. Updates are O(1) per
+// sample plus a small refit once per second.
+class ClockSync
+{
+public:
+    ClockSync();
+
+    // Forget everything, the device rebooted
+    void reset();
+
+    // Feeds one sample and returns its host time in us. receivedAt is when the
+    // host read it, on the same clock as the result. Never less than the
+    // previous result, so a refit cannot reorder samples.
+    qint64 toHost(quint32 deviceTime, qint64 receivedAt);
+
+    // ppm, device clock vs host, once the first device second is fitted
+    bool isFitted() const { return fitted; }
+    double drift() const { return slope * 1e6; }
+
+private:
+    static const int Windows = 32;
+    static const qint64 WindowLength = 1000000;
+
+    qint64 unwrap(quint32 deviceTime);
+    void closeWindow();
+
+    quint32 lastRaw;
+    qint64 wraps;
+    bool started;
+
+    qint64 windowStart;
+    qint64 windowTime;
+    qint64 windowMin;
+
+    qint64 minTime[Windows];
+    qint64 minDelta[Windows];
+    int count;
+    int next;
+
+    double intercept;
+    double slope;
+    qint64 fitOrigin;
+    bool fitted;
+    qint64 lastHost;
+};
+
+#endif // CLOCKSYNC_H
@@ -0,0 +1,58 @@
+#include "cluttermodel.h"
+#include <QtMath>
+
+ClutterModel::ClutterModel(int sweeps, int angleBins)
+    : bins(qMax(1, angleBins))
+{
+    setSweeps(sweeps);
+    clear();
+}
+
+void ClutterModel::setSweeps(int sweeps) {
+    // EWMA with the same centre of mass as an n-sweep moving average
+    alpha = 2.0f / (qMax(1, sweeps) + 1);
+}
+
+void ClutterModel::clear() {
+    for (Bin &bin : bins) {
+        bin = Bin{0, 0, 0, 0, 0, false};
+    }
+}
+
+bool ClutterModel::addSample(float angle, float distance, qint64 timestamp, quint32 sweep) {
+    Bin &bin = bins[qBound(0, qRound(angle), bins.size() - 1)];
+
+    if (distance <= 0 || distance > MaxRange) {
+        bin.moving = false;
+        return false;
+    }
+
+    if (bin.updates == 0) {
+        bin.range = distance;
+        bin.deviation = 0;
+        bin.updatedAt = timestamp;
+        bin.sweep = sweep;
+        bin.updates = 1;
+        bin.moving = false;
+        return false;
+    }
+
+    float closer = bin.range - distance;
+    bin.moving = bin.updates >= WarmupUpdates
+        && closer >= qMax(MinChange, DeviationFactor * bin.deviation);
+
+    if (sweep != bin.sweep || timestamp - bin.updatedAt >= HoldInterval) {
+        // The spread only learns from clutter, a target would widen it
+        // until nothing stands out any more
+        if (bin.moving) {
+            bin.range += alpha / MovingSlowdown * (distance - bin.range);
+        } else {
+            bin.deviation += alpha * (qAbs(distance - bin.range) - bin.deviation);
+            bin.range += alpha * (distance - bin.range);
+        }
+        bin.updatedAt = timestamp;
+        bin.sweep = sweep;
+        ++bin.updates;
+    }
+    return bin.moving;
+}
@@ -0,0 +1,59 @@
+#ifndef CLUTTERMODEL_H
+#define CLUTTERMODEL_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// What the radar normally sees at each degree: walls, furniture, anything
+// that stays put. Each angle keeps an exponentially weighted mean range and
+// mean deviation over about the last n sweeps, taking at most one sample per
+// sweep so a servo holding still does not swamp it. A sample that is
+// significantly closer than the background at its angle is a moving target.
+//
+// Every sample is O(1): one bin lookup and a handful of float operations.
+class ClutterModel
+{
+public:
+    // Closer than the background by at least this much, in cm, and by
+    // DeviationFactor times the usual spread
+    static constexpr float MinChange = 15.0f;
+    static constexpr float DeviationFactor = 3.0f;
+    // Background updates an angle needs before it can flag anything
+    static const int WarmupUpdates = 3;
+    // cm, HC-SR04 limit. Readings past it, or <= 0, are no echo at all
+    static constexpr float MaxRange = 400.0f;
+
+    explicit ClutterModel(int sweeps = 8, int angleBins = 181);
+
+    void setSweeps(int sweeps);
+    void clear();
+
+    // timestamp in us, sweep as counted by SweepTracker. Returns true if the
+    // sample is a moving target. A sample without an echo is neither a target
+    // nor background, it is ignored.
+    bool addSample(float angle, float distance, qint64 timestamp, quint32 sweep);
+
+    int angleBins() const { return bins.size(); }
+
+private:
+    // A servo that holds still, in MANUAL or for the laser, still updates
+    // the background this often
+    static const qint64 HoldInterval = 1000000;
+    // Moving samples blend in this much slower, so a target that stops
+    // becomes clutter after a while instead of straight away
+    static constexpr float MovingSlowdown = 8.0f;
+
+    struct Bin {
+        float range;
+        float deviation;
+        qint64 updatedAt;
+        quint32 sweep;
+        int updates;
+        bool moving;
+    };
+
+    QVector<Bin> bins;
+    float alpha;
+};
+
+#endif // CLUTTERMODEL_H
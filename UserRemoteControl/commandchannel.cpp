@@ -0,0 +1,92 @@
+#include "commandchannel.h"
+
+CommandChannel::CommandChannel(DeviceSession *session, QObject *parent)
+    : QObject(parent)
+    , session(session)
+    , flushTimer(new QTimer(this))
+    , minInterval(50)
+    , nextSequence(0)
+    , inFlight(false)
+    , inFlightSequence(0)
+    , sentAt(-1000)
+    , latency(-1)
+    , timeouts(0)
+{
+    for (int i = 0; i < CommandTypeCount; ++i) {
+        hasPending[i] = false;
+    }
+
+    flushTimer->setSingleShot(true);
+    connect(flushTimer, &QTimer::timeout, this, &CommandChannel::flush);
+    clock.start();
+
+    session->subscribe(Telemetry::AckMessage, [this](const Telemetry::Message &msg) {
+        handleAck(msg.ack);
+    });
+}
+
+void CommandChannel::send(CommandType type, const QByteArray &command) {
+    pending[type] = command;
+    hasPending[type] = true;
+    flush();
+}
+
+void CommandChannel::setMaxRate(int commandsPerSecond) {
+    minInterval = 1000 / qBound(1, commandsPerSecond, 1000);
+}
+
+void CommandChannel::reset() {
+    inFlight = false;
+    flush();
+}
+
+void CommandChannel::flush() {
+    qint64 now = clock.elapsed();
+
+    if (inFlight) {
+        if (now - sentAt < AckTimeout) {
+            flushTimer->start(int(sentAt + AckTimeout - now));
+            return;
+        }
+        inFlight = false;
+        ++timeouts;
+    }
+    if (!session->isOpen()) {
+        // Latest values stay pending, reset() sends them once connected
+        return;
+    }
+    if (now - sentAt < minInterval) {
+        flushTimer->start(int(sentAt + minInterval - now));
+        return;
+    }
+
+    for (int type = 0; type < CommandTypeCount; ++type) {
+        if (hasPending[type]) {
+            hasPending[type] = false;
+            inFlight = true;
+            inFlightSequence = nextSequence++;
+            sentAt = now;
+            session->write(QByteArray::number(inFlightSequence) + ':' + pending[type] + '\n');
+            flushTimer->start(AckTimeout);
+            return;
+        }
+    }
+}
+
+void CommandChannel::handleAck(quint16 sequence) {
+    if (!inFlight || sequence != inFlightSequence) {
+        return;
+    }
+    inFlight = false;
+    latency = int(clock.elapsed() - sentAt);
+    emit commandAcked(sequence, latency);
+    flush();
+}
+
+int CommandChannel::pendingCommands() const {
+    int count = inFlight ? 1 : 0;
+    for (int type = 0; type < CommandTypeCount; ++type) {
+        count += hasPending[type] ? 1 : 0;
+    }
+    return count;
+}
@@ -0,0 +1,67 @@
+#ifndef COMMANDCHANNEL_H
+#define COMMANDCHANNEL_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include "devicesession.h"
+
+// Rate limited, acknowledged commands to the firmware. Each command type keeps
+// only its latest value, and at most one command is in flight: the next one
+// goes out when the firmware acks "<seq>:<command>" or the ack times out. The
+// UART never queues more than one line, so command latency stays bounded.
+class CommandChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    // In priority order, a pending mode change goes out before a servo angle
+    enum CommandType {
+        LaserModeCommand,
+        ModeCommand,
+        LaserCommand,
+        ServoCommand,
+        CommandTypeCount
+    };
+
+    explicit CommandChannel(DeviceSession *session, QObject *parent = nullptr);
+
+    void send(CommandType type, const QByteArray &command);
+    void setMaxRate(int commandsPerSecond);
+
+    // Drops the in-flight command, e.g. after the board reset on reconnect
+    void reset();
+
+    int lastLatency() const { return latency; }
+    // Commands waiting to go out, plus the one in flight
+    int pendingCommands() const;
+    quint64 timedOutCommands() const { return timeouts; }
+
+signals:
+    void commandAcked(quint16 sequence, int latencyMs);
+
+private slots:
+    void flush();
+
+private:
+    // The firmware acks from its next loop, at most ~90 ms away: the 30 ms
+    // echo timeout, delay(50) and the INA219 reads
+    static const int AckTimeout = 250;
+
+    void handleAck(quint16 sequence);
+
+    DeviceSession *session;
+    QByteArray pending[CommandTypeCount];
+    bool hasPending[CommandTypeCount];
+    QTimer *flushTimer;
+    QElapsedTimer clock;
+    int minInterval;
+    quint16 nextSequence;
+    bool inFlight;
+    quint16 inFlightSequence;
+    qint64 sentAt;
+    int latency;
+    quint64 timeouts;
+};
+
+#endif // COMMANDCHANNEL_H
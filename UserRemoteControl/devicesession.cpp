@@ -0,0 +1,46 @@
+#include "devicesession.h"
+
+DeviceSession::DeviceSession(QObject *parent)
+    : QObject(parent)
+    , worker(new DeviceWorker)
+{
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &DeviceWorker::connectionChanged, this, &DeviceSession::connectionChanged);
+    connect(worker, &DeviceWorker::statisticsChanged, this, &DeviceSession::statisticsChanged);
+    thread.start();
+}
+
+DeviceSession::~DeviceSession() {
+    // The worker closes its port when it is deleted on thread exit
+    thread.quit();
+    thread.wait();
+}
+
+void DeviceSession::open(const QString &spec) {
+    worker->open(spec);
+}
+
+void DeviceSession::connectToDevice(quint16 vendorId, quint16 productId) {
+    worker->connectToDevice(vendorId, productId);
+}
+
+void DeviceSession::write(const QByteArray &data) {
+    worker->write(data);
+}
+
+void DeviceSession::subscribe(Telemetry::MessageId channel, const Subscriber &subscriber) {
+    subscribers[channel].append(subscriber);
+}
+
+int DeviceSession::poll() {
+    int delivered = 0;
+    Telemetry::Message msg;
+    while (worker->takeMessage(msg)) {
+        for (const Subscriber &subscriber : std::as_const(subscribers[msg.id])) {
+            subscriber(msg);
+        }
+        ++delivered;
+    }
+    return delivered;
+}
@@ -0,0 +1,50 @@
+#ifndef DEVICESESSION_H
+#define DEVICESESSION_H
+
+#include <QObject>
+#include <QThread>
+#include <functional>
+#include "deviceworker.h"
+
+// The one connection to the rover. A single port and parse path on the device
+// thread feeds every channel; each message id (radar, battery, laser, ...) is a
+// channel that any number of subscribers can listen to on the GUI thread.
+class DeviceSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<void(const Telemetry::Message &)> Subscriber;
+
+    explicit DeviceSession(QObject *parent = nullptr);
+    ~DeviceSession();
+
+    // portName or any other spec Transport::create() understands
+    void open(const QString &spec);
+    // Finds the port by USB ids in the background and keeps reconnecting to it
+    void connectToDevice(quint16 vendorId, quint16 productId);
+    void write(const QByteArray &data);
+    bool isOpen() const { return worker->isOpen(); }
+
+    void subscribe(Telemetry::MessageId channel, const Subscriber &subscriber);
+
+    // Hands everything queued since the last call to the channel subscribers.
+    // Returns the number of messages delivered.
+    int poll();
+
+    int pendingMessages() const { return worker->pendingMessages(); }
+    quint64 droppedMessages() const { return worker->droppedMessages(); }
+    // us, on the same clock as the message timestamps
+    qint64 hostTime() const { return worker->hostTime(); }
+
+signals:
+    void connectionChanged(bool connected, const QString &portName);
+    void statisticsChanged(const LinkStatistics &stats);
+
+private:
+    QThread thread;
+    DeviceWorker *worker;
+    QList<Subscriber> subscribers[256];
+};
+
+#endif // DEVICESESSION_H
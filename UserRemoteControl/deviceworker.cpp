@@ -0,0 +1,225 @@
+#include "deviceworker.h"
+#include "sampleparser.h"
+#include <QDateTime>
+#include <QLoggingCategory>
+#include <QSerialPortInfo>
+#include <cctype>
+#include <cstring>
+
+// Connection details, off by default since a missing board retries every
+// 50 ms. QT_LOGGING_RULES="rover.device.debug=true" turns them on.
+Q_LOGGING_CATEGORY(lcDevice, "rover.device", QtWarningMsg)
+
+DeviceWorker::DeviceWorker(QObject *parent)
+    : QObject(parent)
+    , transport(nullptr)
+    , reconnectTimer(nullptr)
+    , statisticsTimer(nullptr)
+    , vendorId(0)
+    , productId(0)
+    , backoff(MinBackoff)
+    , framing(Telemetry::AutoDetectFraming)
+    , epochAnchor(QDateTime::currentMSecsSinceEpoch() * 1000)
+    , queue(4096)
+    , portOpen(false)
+    , dropped(0)
+{
+    // Host timestamps are us since epoch, but advance on the monotonic clock
+    hostClock.start();
+}
+
+void DeviceWorker::open(const QString &spec) {
+    QMetaObject::invokeMethod(this, [this, spec]() {
+        vendorId = 0;
+        productId = 0;
+        backoff = MinBackoff;
+        if (!openTransport(spec)) {
+            scheduleReconnect();
+        }
+    });
+}
+
+void DeviceWorker::connectToDevice(quint16 vendorId, quint16 productId) {
+    QMetaObject::invokeMethod(this, [this, vendorId, productId]() {
+        this->vendorId = vendorId;
+        this->productId = productId;
+        backoff = MinBackoff;
+        reconnect();
+    });
+}
+
+void DeviceWorker::write(const QByteArray &data) {
+    QMetaObject::invokeMethod(this, [this, data]() { writeTransport(data); });
+}
+
+bool DeviceWorker::openTransport(const QString &spec) {
+    // Created here so the timer lives on the device thread
+    if (!statisticsTimer) {
+        statisticsTimer = new QTimer(this);
+        connect(statisticsTimer, &QTimer::timeout, this, &DeviceWorker::publishStatistics);
+    }
+    if (transport) {
+        transport->disconnect(this);
+        transport->close();
+        transport->deleteLater();
+    }
+    this->spec = spec;
+    transport = Transport::create(spec, this);
+    connect(transport, &Transport::readyRead, this, &DeviceWorker::readTransport);
+    connect(transport, &Transport::lost, this, &DeviceWorker::handleLost);
+
+    // The board resets on open, start over with a clean stream
+    buffer.clear();
+    framing = Telemetry::AutoDetectFraming;
+    clockSync.reset();
+    linkStats.reset(hostTime());
+
+    if (transport->open()) {
+        qCDebug(lcDevice) << "Opened" << transport->name();
+        backoff = MinBackoff;
+        portOpen.store(true, std::memory_order_relaxed);
+        statisticsTimer->start(StatisticsInterval);
+        emit connectionChanged(true, transport->name());
+        return true;
+    }
+
+    qCDebug(lcDevice) << "Failed to open" << transport->name() << transport->errorString();
+    portOpen.store(false, std::memory_order_relaxed);
+    statisticsTimer->stop();
+    return false;
+}
+
+void DeviceWorker::handleLost() {
+    qCDebug(lcDevice) << "Lost" << transport->name() << transport->errorString();
+    transport->close();
+    portOpen.store(false, std::memory_order_relaxed);
+    statisticsTimer->stop();
+    publishStatistics();
+    emit connectionChanged(false, transport->name());
+
+    backoff = MinBackoff;
+    scheduleReconnect();
+}
+
+void DeviceWorker::reconnect() {
+    if (transport && transport->isOpen()) {
+        return;
+    }
+
+    if (vendorId || productId) {
+        const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+        for (const QSerialPortInfo &info : ports) {
+            if (info.hasVendorIdentifier() && info.hasProductIdentifier()
+                && info.vendorIdentifier() == vendorId && info.productIdentifier() == productId) {
+                if (openTransport(info.portName())) {
+                    return;
+                }
+            }
+        }
+    } else if (!spec.isEmpty() && openTransport(spec)) {
+        return;
+    }
+
+    scheduleReconnect();
+}
+
+void DeviceWorker::scheduleReconnect() {
+    // Created here so the timer lives on the device thread
+    if (!reconnectTimer) {
+        reconnectTimer = new QTimer(this);
+        reconnectTimer->setSingleShot(true);
+        connect(reconnectTimer, &QTimer::timeout, this, &DeviceWorker::reconnect);
+    }
+    reconnectTimer->start(backoff);
+    backoff = qMin(backoff * 2, int(MaxBackoff));
+}
+
+void DeviceWorker::writeTransport(const QByteArray &data) {
+    if (transport && transport->isOpen()) {
+        transport->write(data);
+    } else {
+        qCDebug(lcDevice) << "Couldn't write to serial!";
+    }
+}
+
+void DeviceWorker::readTransport() {
+    // Read straight into the ring, lines and frames are handed out as views into it
+    for (;;) {
+        int room;
+        char *dst = buffer.writePointer(&room);
+        qint64 count = transport->read(dst, room);
+        if (count <= 0) {
+            break;
+        }
+        qint64 receivedAt = hostTime();
+        linkStats.addBytes(count);
+
+        // Binary firmware ends every frame with 0x00, the ASCII protocol never sends it
+        if (framing == Telemetry::AutoDetectFraming && memchr(dst, 0, count)) {
+            framing = Telemetry::BinaryFraming;
+        }
+        buffer.commit(int(count));
+
+        const char *record;
+        int size;
+        if (framing == Telemetry::BinaryFraming) {
+            while (buffer.takeRecord('\0', &record, &size)) {
+                Telemetry::Message msg;
+                Telemetry::DecodeError error;
+                if (Telemetry::decodeFrame(record, size, msg, &error)) {
+                    stamp(msg, receivedAt);
+                    linkStats.addMessage(msg, receivedAt);
+                    publish(msg);
+                } else if (error == Telemetry::CrcError) {
+                    linkStats.addCrcError();
+                } else {
+                    linkStats.addFramingError();
+                }
+            }
+        } else {
+            while (buffer.takeRecord('\n', &record, &size)) {
+                Telemetry::Message msg;
+                if (SampleParser::parseLine(record, record + size, msg)) {
+                    stamp(msg, receivedAt);
+                    linkStats.addMessage(msg, receivedAt);
+                    publish(msg);
+                } else if (size > 0 && (isdigit(quint8(record[0])) || record[0] == 'B')) {
+                    // Only lines that started out as samples, not the startup banner
+                    linkStats.addFramingError();
+                }
+            }
+        }
+    }
+}
+
+void DeviceWorker::publishStatistics() {
+    LinkStatistics stats = linkStats.snapshot(hostTime(), droppedMessages());
+    stats.clockFitted = clockSync.isFitted();
+    stats.clockDrift = clockSync.drift();
+    emit statisticsChanged(stats);
+}
+
+qint64 DeviceWorker::hostTime() const {
+    return epochAnchor + hostClock.nsecsElapsed() / 1000;
+}
+
+void DeviceWorker::stamp(Telemetry::Message &msg, qint64 receivedAt) {
+    // Firmware without timestamps falls back to the receive time
+    switch (msg.id) {
+    case Telemetry::RadarMessage:
+        msg.radar.timestamp = msg.hasDeviceTime ? clockSync.toHost(msg.radar.deviceTime, receivedAt) : receivedAt;
+        break;
+    case Telemetry::BatteryMessage:
+        msg.battery.timestamp = msg.hasDeviceTime ? clockSync.toHost(msg.battery.deviceTime, receivedAt) : receivedAt;
+        break;
+    default:
+        break;
+    }
+}
+
+void DeviceWorker::publish(const Telemetry::Message &msg) {
+    // A full queue means the GUI is behind, drop rather than stall the port
+    if (!queue.push(msg)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef DEVICEWORKER_H
+#define DEVICEWORKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <atomic>
+#include "byteringbuffer.h"
+#include "clocksync.h"
+#include "linkstats.h"
+#include "spscqueue.h"
+#include "telemetryprotocol.h"
+#include "transport.h"
+
+// Owns one Transport on the device thread. Incoming bytes are split and
+// parsed there and pushed as typed messages into a lock-free queue that the
+// GUI drains on its own schedule. open(), connectToDevice() and write() may be
+// called from any thread, they are forwarded to the device thread.
+//
+// A transport that drops out is reopened automatically, retrying with
+// exponential backoff. With connectToDevice() the retries rescan for the USB
+// ids, which also picks the device up when it is plugged in later or
+// re-enumerates.
+//
+// While a transport is open, link statistics go out twice a second.
+class DeviceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceWorker(QObject *parent = nullptr);
+
+    // spec as for Transport::create()
+    void open(const QString &spec);
+    void connectToDevice(quint16 vendorId, quint16 productId);
+    void write(const QByteArray &data);
+    bool isOpen() const { return portOpen.load(std::memory_order_relaxed); }
+
+    // GUI side of the queue
+    bool takeMessage(Telemetry::Message &msg) { return queue.pop(msg); }
+    int pendingMessages() const { return queue.size(); }
+    quint64 droppedMessages() const { return dropped.load(std::memory_order_relaxed); }
+    // us since the epoch, monotonic, the clock all sample timestamps are on.
+    // Safe from any thread.
+    qint64 hostTime() const;
+
+signals:
+    void connectionChanged(bool connected, const QString &portName);
+    void statisticsChanged(const LinkStatistics &stats);
+
+private slots:
+    void readTransport();
+    void handleLost();
+    void reconnect();
+    void publishStatistics();
+
+private:
+    static const int MinBackoff = 50;
+    static const int MaxBackoff = 2000;
+    static const int StatisticsInterval = 500;
+
+    bool openTransport(const QString &spec);
+    void scheduleReconnect();
+    void stamp(Telemetry::Message &msg, qint64 receivedAt);
+    void writeTransport(const QByteArray &data);
+    void publish(const Telemetry::Message &msg);
+
+    Transport *transport;
+    QTimer *reconnectTimer;
+    QTimer *statisticsTimer;
+    QString spec;
+    quint16 vendorId;
+    quint16 productId;
+    int backoff;
+    ByteRingBuffer buffer;
+    Telemetry::Framing framing;
+    ClockSync clockSync;
+    LinkStats linkStats;
+    QElapsedTimer hostClock;
+    qint64 epochAnchor;
+    SpscQueue<Telemetry::Message> queue;
+    std::atomic<bool> portOpen;
+    std::atomic<quint64> dropped;
+};
+
+#endif // DEVICEWORKER_H
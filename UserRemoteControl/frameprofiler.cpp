@@ -0,0 +1,142 @@
+#include "frameprofiler.h"
+#include <QTextStream>
+#include <algorithm>
+#include <cstring>
+
+FrameProfiler::FrameProfiler()
+    : ring(History)
+    , scratch(History)
+{
+    clock.start();
+    clear();
+}
+
+int FrameProfiler::addStage(const QString &name) {
+    Q_ASSERT(stageNames.size() < MaxStages);
+    stageNames.append(name);
+    return stageNames.size() - 1;
+}
+
+int FrameProfiler::addCounter(const QString &name) {
+    Q_ASSERT(counterNames.size() < MaxCounters);
+    counterNames.append(name);
+    return counterNames.size() - 1;
+}
+
+void FrameProfiler::clear() {
+    next = 0;
+    frames = 0;
+    memset(&current, 0, sizeof(current));
+    memset(started, 0, sizeof(started));
+    current.start = -1;
+}
+
+void FrameProfiler::beginFrame() {
+    qint64 now = clock.nsecsElapsed();
+    if (current.start >= 0) {
+        current.period = now - current.start;
+        ring[next] = current;
+        next = (next + 1) % History;
+        frames = qMin(frames + 1, int(History));
+    }
+    memset(&current, 0, sizeof(current));
+    current.start = now;
+}
+
+void FrameProfiler::begin(int stage) {
+    started[stage] = clock.nsecsElapsed();
+}
+
+void FrameProfiler::end(int stage) {
+    // A stage may run several times per frame, e.g. repaints
+    current.stages[stage] += clock.nsecsElapsed() - started[stage];
+}
+
+const FrameProfiler::Frame &FrameProfiler::frame(int age) const {
+    // age 0 is the oldest recorded frame
+    return ring[(next - frames + age + History) % History];
+}
+
+qint64 FrameProfiler::duration(const Frame &frame, int stage) const {
+    if (stage >= 0) {
+        return frame.stages[stage];
+    }
+    qint64 total = 0;
+    for (int i = 0; i < stageNames.size(); ++i) {
+        total += frame.stages[i];
+    }
+    return total;
+}
+
+double FrameProfiler::framesPerSecond() const {
+    qint64 span = 0;
+    for (int i = 0; i < frames; ++i) {
+        span += frame(i).period;
+    }
+    return span > 0 ? frames * 1e9 / span : 0;
+}
+
+double FrameProfiler::percentile(int stage, double fraction) const {
+    if (frames == 0) {
+        return 0;
+    }
+    for (int i = 0; i < frames; ++i) {
+        scratch[i] = duration(frame(i), stage);
+    }
+    int rank = qBound(0, int(fraction * frames), frames - 1);
+    std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.begin() + frames);
+    return scratch[rank] / 1e6;
+}
+
+double FrameProfiler::maximum(int stage) const {
+    qint64 longest = 0;
+    for (int i = 0; i < frames; ++i) {
+        longest = qMax(longest, duration(frame(i), stage));
+    }
+    return longest / 1e6;
+}
+
+double FrameProfiler::rate(int counter) const {
+    qint64 span = 0;
+    qint64 total = 0;
+    for (int i = 0; i < frames; ++i) {
+        span += frame(i).period;
+        total += frame(i).counters[counter];
+    }
+    return span > 0 ? total * 1e9 / span : 0;
+}
+
+qint64 FrameProfiler::latest(int counter) const {
+    return frames > 0 ? frame(frames - 1).counters[counter] : 0;
+}
+
+qint64 FrameProfiler::peak(int counter) const {
+    qint64 highest = 0;
+    for (int i = 0; i < frames; ++i) {
+        highest = qMax(highest, frame(i).counters[counter]);
+    }
+    return highest;
+}
+
+void FrameProfiler::writeCsv(QTextStream &out) const {
+    out << "start_us,period_us,total_us";
+    for (const QString &name : stageNames) {
+        out << ',' << name << "_us";
+    }
+    for (const QString &name : counterNames) {
+        out << ',' << name;
+    }
+    out << '\n';
+
+    for (int i = 0; i < frames; ++i) {
+        const Frame &f = frame(i);
+        out << f.start / 1000 << ',' << f.period / 1000 << ',' << duration(f, -1) / 1000;
+        for (int s = 0; s < stageNames.size(); ++s) {
+            out << ',' << f.stages[s] / 1000;
+        }
+        for (int c = 0; c < counterNames.size(); ++c) {
+            out << ',' << f.counters[c];
+        }
+        out << '\n';
+    }
+}
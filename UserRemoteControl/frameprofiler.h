@@ -0,0 +1,93 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTextStream;
+
+// Where the display frame goes. Stages (poll, decay, scene paint, ...) are
+// timed into the frame in progress, counters record per-frame figures such
+// as samples ingested or queue depth. beginFrame() closes the previous frame
+// into a ring of the last History frames, so recording never allocates and
+// costs two clock reads per stage.
+//
+// A frame runs from one beginFrame() to the next, so work that happens in
+// between, like the view repainting after renderFrame(), is counted in the
+// frame that caused it.
+class FrameProfiler
+{
+public:
+    static const int History = 600;  // 10 s at 60 Hz
+    static const int MaxStages = 8;
+    static const int MaxCounters = 8;
+
+    FrameProfiler();
+
+    // Register once up front, the returned id is used to record
+    int addStage(const QString &name);
+    int addCounter(const QString &name);
+    int stageCount() const { return stageNames.size(); }
+    int counterCount() const { return counterNames.size(); }
+    QString stageName(int stage) const { return stageNames[stage]; }
+    QString counterName(int counter) const { return counterNames[counter]; }
+
+    void beginFrame();
+    void clear();
+
+    void begin(int stage);
+    void end(int stage);
+    void addCount(int counter, qint64 count = 1) { current.counters[counter] += count; }
+    void setCounter(int counter, qint64 value) { current.counters[counter] = value; }
+
+    // Times a stage for the lifetime of the object
+    class Scope
+    {
+    public:
+        Scope(FrameProfiler &profiler, int stage) : profiler(profiler), stage(stage) { profiler.begin(stage); }
+        ~Scope() { profiler.end(stage); }
+
+    private:
+        FrameProfiler &profiler;
+        int stage;
+    };
+
+    // Over the recorded frames. Times in ms; stage -1 is the whole frame,
+    // the sum of all stages.
+    int frameCount() const { return frames; }
+    double framesPerSecond() const;
+    double percentile(int stage, double fraction) const;
+    double maximum(int stage) const;
+    // Counter summed over the recorded frames, per second
+    double rate(int counter) const;
+    qint64 latest(int counter) const;
+    qint64 peak(int counter) const;
+
+    // One row per recorded frame, oldest first
+    void writeCsv(QTextStream &out) const;
+
+private:
+    struct Frame {
+        qint64 start;  // ns on clock
+        qint64 period;
+        qint64 stages[MaxStages];
+        qint64 counters[MaxCounters];
+    };
+
+    const Frame &frame(int age) const;
+    qint64 duration(const Frame &frame, int stage) const;
+
+    QElapsedTimer clock;
+    QStringList stageNames;
+    QStringList counterNames;
+    QVector<Frame> ring;
+    int next;
+    int frames;
+    Frame current;
+    qint64 started[MaxStages];
+    mutable QVector<qint64> scratch;
+};
+
+#endif // FRAMEPROFILER_H
@@ -0,0 +1,74 @@
+#include "linkstats.h"
+#include <cstring>
+
+LinkStats::LinkStats() {
+    reset(0);
+}
+
+void LinkStats::reset(qint64 now) {
+    memset(&stats, 0, sizeof(stats));
+    memset(trackers, 0, sizeof(trackers));
+    bytesAtSnapshot = 0;
+    snapshotTime = now;
+}
+
+void LinkStats::addMessage(const Telemetry::Message &msg, qint64 receivedAt) {
+    if (msg.id >= LinkStatistics::Channels) {
+        return;
+    }
+    LinkStatistics::Channel &channel = stats.channels[msg.id];
+    Tracker &tracker = trackers[msg.id];
+    ++channel.received;
+
+    if (msg.hasSequence) {
+        // Serial arithmetic, anything within half the range ahead is a gap
+        quint16 ahead = quint16(msg.sequence - tracker.expected);
+        if (!tracker.started || ahead < 0x8000) {
+            if (tracker.started) {
+                channel.lost += ahead;
+            }
+            tracker.expected = quint16(msg.sequence + 1);
+        } else {
+            ++channel.reordered;
+        }
+    }
+
+    quint32 deviceTime = 0;
+    if (msg.hasDeviceTime) {
+        deviceTime = msg.id == Telemetry::RadarMessage ? msg.radar.deviceTime : msg.battery.deviceTime;
+    }
+
+    if (tracker.started) {
+        double deviation;
+        if (msg.hasDeviceTime) {
+            // Transit time change between consecutive samples, as in RFC 3550
+            qint64 sent = quint32(deviceTime - tracker.lastDeviceTime);
+            deviation = double((receivedAt - tracker.lastReceived) - sent);
+        } else {
+            // No device clock, measure against the average spacing instead
+            double interval = double(receivedAt - tracker.lastReceived);
+            tracker.meanInterval += (interval - tracker.meanInterval) / 16;
+            deviation = interval - tracker.meanInterval;
+        }
+        channel.jitter += (qAbs(deviation) - channel.jitter) / 16;
+    }
+    tracker.started = true;
+    tracker.lastReceived = receivedAt;
+    tracker.lastDeviceTime = deviceTime;
+}
+
+LinkStatistics LinkStats::snapshot(qint64 now, quint64 dropped) {
+    double seconds = (now - snapshotTime) / 1e6;
+    if (seconds > 0) {
+        for (int i = 0; i < LinkStatistics::Channels; ++i) {
+            LinkStatistics::Channel &channel = stats.channels[i];
+            channel.rate = (channel.received - trackers[i].receivedAtSnapshot) / seconds;
+            trackers[i].receivedAtSnapshot = channel.received;
+        }
+        stats.byteRate = (stats.bytes - bytesAtSnapshot) / seconds;
+        bytesAtSnapshot = stats.bytes;
+        snapshotTime = now;
+    }
+    stats.dropped = dropped;
+    return stats;
+}
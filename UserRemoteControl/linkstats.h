@@ -0,0 +1,65 @@
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+#include <QMetaType>
+#include <QtGlobal>
+#include "telemetryprotocol.h"
+
+// Link quality as seen by the host. Counters are totals since the port was
+// opened, rates cover the interval since the previous snapshot.
+struct LinkStatistics {
+    static const int Channels = Telemetry::AckMessage + 1;  // indexed by MessageId
+
+    struct Channel {
+        quint64 received;
+        quint64 lost;       // skipped sequence numbers
+        quint64 reordered;  // late or duplicate sequence numbers
+        double rate;        // messages/s
+        double jitter;      // us, RFC 3550 style interarrival jitter
+    };
+
+    Channel channels[Channels];
+    quint64 bytes;
+    quint64 crcErrors;
+    quint64 framingErrors;  // bad COBS frames or unparseable lines
+    quint64 dropped;        // queue overflows on the host
+    double byteRate;        // bytes/s
+    bool clockFitted;
+    double clockDrift;      // ppm, device clock vs host, once clockFitted
+};
+
+Q_DECLARE_METATYPE(LinkStatistics)
+
+// Collects LinkStatistics on the device thread, O(1) per message
+class LinkStats
+{
+public:
+    LinkStats();
+
+    void reset(qint64 now);
+
+    void addBytes(qint64 count) { stats.bytes += quint64(count); }
+    void addCrcError() { ++stats.crcErrors; }
+    void addFramingError() { ++stats.framingErrors; }
+    void addMessage(const Telemetry::Message &msg, qint64 receivedAt);
+
+    // Returns the statistics with rates since the last call, now in us
+    LinkStatistics snapshot(qint64 now, quint64 dropped);
+
+private:
+    struct Tracker {
+        bool started;
+        quint16 expected;
+        qint64 lastReceived;
+        quint32 lastDeviceTime;
+        double meanInterval;
+        quint64 receivedAtSnapshot;
+    };
+
+    LinkStatistics stats;
+    Tracker trackers[LinkStatistics::Channels];
+    quint64 bytesAtSnapshot;
+    qint64 snapshotTime;
+};
+
+#endif // LINKSTATS_H
@@ -1,10 +1,20 @@
 #include "mainwindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
+
+    // e.g. --transport pty:/dev/pts/3 for the emulator, or
+    // --transport "replay:capture.bin?rate=0" to benchmark without hardware
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption transportOption("transport", "Connect to <spec> instead of searching for the Arduino.", "spec");
+    parser.addOption(transportOption);
+    parser.process(a);
+
+    MainWindow w(parser.value(transportOption));
     w.show();
     return a.exec();
 }
@@ -2,19 +2,26 @@
 #include "ui_mainwindow.h"
 #include <QSerialPort>
 #include <QSerialPortInfo>
+#include <QFileDialog>
+#include <QMessageBox>
 #include <QTimer>
 #include <QDebug>
 #include <QtMath>
 
-MainWindow::MainWindow(QWidget *parent)
+MainWindow::MainWindow(const QString &transport, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , batterySerial(new QSerialPort(this))
     , batteryTimer(new QTimer(this))
     , maxExpectedPower(1500.0)
-    , batteryDataBuffer()
-    , r(445.0)
-    , angleOffset(0.05)
+    , hasLatestBattery(false)
+    , r(RadarView::MaxRange)
+    , radarOrigin(505, 495)
+    , needleFrom(0)
+    , needleTo(0)
+    , needleStart(0)
+    , needleDuration(0)
+    , hasPendingRadar(false)
+    , hasPendingBattery(false)
     , laserActive(false)
     , autoMode(false)
     , previousAutoMode(false)
@@ -22,53 +29,174 @@ MainWindow::MainWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
-    // Load bg image (radar)
+    // The view draws the scope itself, the scene only holds what is on it
     scene = new QGraphicsScene(this);
     ui->graphicsView->setScene(scene);
-    pix = QPixmap(":/src/radar.png");
-    scene->addPixmap(pix);
+    ui->graphicsView->setOrigin(radarOrigin);
+
+    // Where each display frame goes, with an optional overlay on the radar
+    for (const char *stage : {"poll", "readout", "display", "battery", "history", "paint"}) {
+        profiler.addStage(stage);
+    }
+    for (const char *counter : {"samples", "points", "telemetry_queue", "command_queue", "dropped", "repaint_px"}) {
+        profiler.addCounter(counter);
+    }
+    ui->graphicsView->setProfiler(&profiler, PaintStage);
+    renderStatsLabel = new QLabel(ui->graphicsView);
+    renderStatsLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
+    renderStatsLabel->setStyleSheet("background: rgba(0, 0, 0, 160); color: white; padding: 4px;");
+    renderStatsLabel->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    renderStatsLabel->move(8, 8);
+    renderStatsLabel->hide();
+    renderStatsTimer = new QTimer(this);
+    connect(renderStatsTimer, &QTimer::timeout, this, &MainWindow::updateRenderStats);
+
+    // One session reads and parses the port, each channel feeds its subscriber
+    arduino = new DeviceSession(this);
+    arduino->subscribe(Telemetry::RadarMessage, [this](const Telemetry::Message &msg) {
+        handleRadarSample(msg.radar);
+    });
+    arduino->subscribe(Telemetry::BatteryMessage, [this](const Telemetry::Message &msg) {
+        pendingBattery = msg.battery;
+        hasPendingBattery = true;
+    });
+    arduino->subscribe(Telemetry::LaserMessage, [this](const Telemetry::Message &msg) {
+        if (msg.laser == Telemetry::LaserActivated) {
+            handleLaserActivation();
+        } else {
+            deactivateLaser();
+        }
+    });
+
+    // Samples collect between frames and are applied once per frame
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &MainWindow::renderFrame);
+    setDisplayRate(60);
 
-    // Set up QSerialPort
-    arduino = new QSerialPort;
     arduino_is_available = false;
     radarSerial = "COM9";
 
-    // Initialize needle at 0 degrees
+    // The needle is built once at 0 degrees and only ever rotated about the
+    // origin, and scaled to the range shown
     QPen blackpen(Qt::black);
     QBrush graybrush(Qt::gray);
-    t_up = angleOffset;
-    t_lo = -angleOffset;
-    triangle.append(QPointF(r * qCos(t_up) + 505, -r * qSin(t_up) + 495));
-    triangle.append(QPointF(505, 495));
-    triangle.append(QPointF(r * qCos(t_lo) + 505, -r * qSin(t_lo) + 495));
-    needle = scene->addPolygon(triangle, blackpen, graybrush);
+    needle = scene->addPolygon(needlePolygon(0), blackpen, graybrush);
     needle->setOpacity(0.30);
-
-    // Check which port the Arduino is on
-    foreach (const QSerialPortInfo &serialPortInfo, QSerialPortInfo::availablePorts()) {
-        if (serialPortInfo.hasVendorIdentifier() && serialPortInfo.hasProductIdentifier()) {
-            if (serialPortInfo.vendorIdentifier() == arduino_uno_vendorID) {
-                if (serialPortInfo.productIdentifier() == arduino_uno_productID) {
-                    radarSerial = serialPortInfo.portName();
-                    arduino_is_available = true;
-                    qDebug() << "Port available!";
-                }
-            }
-        }
+    needle->setTransformOriginPoint(radarOrigin);
+    needleClock.start();
+
+    // Detections are drawn above the needle, all of them by one item: fading
+    // on a phosphor layer, as the points of the last few sweeps, or as the
+    // outline of the current sweep
+    phosphor = new PhosphorItem(QSizeF(radarOrigin.x() + RadarView::MaxRange + 10, radarOrigin.y() + 10).toSize());
+    phosphor->setColor(Qt::red);
+    phosphor->setPersistence(3000);
+    scene->addItem(phosphor);
+    detectionPoints = new PointCloudItem(PointCapacity);
+    detectionPoints->setBrush(Qt::red);
+    scene->addItem(detectionPoints);
+    occupancyItem = new OccupancyGridItem(&radarGrid, radarOrigin);
+    occupancyItem->setColor(Qt::red);
+    scene->addItem(occupancyItem);
+    sweepContour = new SweepContourItem(radarOrigin);
+    sweepContour->setColor(Qt::red);
+    scene->addItem(sweepContour);
+
+    // Moving targets stand out on top of every display mode
+    movingPoints = new PointCloudItem(MovingCapacity);
+    movingPoints->setBrush(Qt::yellow);
+    movingPoints->setRetention(PointCloudItem::RetainTime, 2000);
+    scene->addItem(movingPoints);
+
+    radarDisplayBox = new QComboBox(this);
+    radarDisplayBox->addItem("Phosphor", PhosphorDisplay);
+    radarDisplayBox->addItem("Points", PointDisplay);
+    radarDisplayBox->addItem("Occupancy", OccupancyDisplay);
+    radarDisplayBox->addItem("Contour", ContourDisplay);
+    radarDisplayBox->addItem("Filled contour", FilledContourDisplay);
+    ui->statusbar->addPermanentWidget(radarDisplayBox);
+    connect(radarDisplayBox, &QComboBox::currentIndexChanged, this, [this](int index) {
+        setRadarDisplay(radarDisplayBox->itemData(index).toInt());
+    });
+    setRadarDisplay(PhosphorDisplay);
+
+    // How far back the points go, in sweeps or seconds
+    retentionBox = new QSpinBox(this);
+    retentionBox->setRange(1, 600);
+    retentionBox->setValue(2);
+    retentionBox->setPrefix("Last ");
+    ui->statusbar->addPermanentWidget(retentionBox);
+    retentionModeBox = new QComboBox(this);
+    retentionModeBox->addItem("sweeps", PointCloudItem::RetainSweeps);
+    retentionModeBox->addItem("s", PointCloudItem::RetainTime);
+    ui->statusbar->addPermanentWidget(retentionModeBox);
+    connect(retentionBox, &QSpinBox::valueChanged, this, &MainWindow::updateRetention);
+    connect(retentionModeBox, &QComboBox::currentIndexChanged, this, &MainWindow::updateRetention);
+    updateRetention();
+
+    // Range shown on the scope, the mouse wheel changes it too
+    rangeBox = new QDoubleSpinBox(this);
+    rangeBox->setRange(RadarView::MinRange / 100, RadarView::MaxRange / 100);
+    rangeBox->setSingleStep(0.5);
+    rangeBox->setDecimals(1);
+    rangeBox->setPrefix("Range ");
+    rangeBox->setSuffix(" m");
+    rangeBox->setValue(ui->graphicsView->range() / 100);
+    needle->setScale(ui->graphicsView->range() / RadarView::MaxRange);
+    ui->statusbar->addPermanentWidget(rangeBox);
+    connect(rangeBox, &QDoubleSpinBox::valueChanged, this, [this](double metres) {
+        ui->graphicsView->setRange(metres * 100);
+    });
+    connect(ui->graphicsView, &RadarView::rangeChanged, this, [this](qreal range) {
+        QSignalBlocker blocker(rangeBox);
+        rangeBox->setValue(range / 100);
+        needle->setScale(range / RadarView::MaxRange);
+    });
+
+    QMenu *fileMenu = ui->menubar->addMenu("&File");
+    fileMenu->addAction("&Export radar map...", this, &MainWindow::exportRadarMap);
+    fileMenu->addAction("Export &frame timings...", this, &MainWindow::exportFrameTimings);
+    QMenu *viewMenu = ui->menubar->addMenu("&View");
+    QAction *renderStatsAction = viewMenu->addAction("&Render statistics");
+    renderStatsAction->setCheckable(true);
+    renderStatsAction->setShortcut(Qt::Key_F3);
+    connect(renderStatsAction, &QAction::toggled, this, &MainWindow::setRenderStatsVisible);
+
+    // Lower rates leave more CPU to the ingest path on slow machines
+    QMenu *rateMenu = viewMenu->addMenu("Display &rate");
+    QActionGroup *rateGroup = new QActionGroup(this);
+    for (int hz : {30, 60}) {
+        QAction *rateAction = rateMenu->addAction(QString("%1 Hz").arg(hz), this, [this, hz]() {
+            setDisplayRate(hz);
+        });
+        rateAction->setCheckable(true);
+        rateAction->setChecked(hz == 60);
+        rateGroup->addAction(rateAction);
     }
 
-    // Setup port if available
-    if (arduino_is_available) {
-        arduino->setPortName(radarSerial);
-        arduino->open(QSerialPort::ReadWrite);
-        arduino->setBaudRate(QSerialPort::Baud115200);
-        arduino->setDataBits(QSerialPort::Data8);
-        arduino->setParity(QSerialPort::NoParity);
-        arduino->setStopBits(QSerialPort::OneStop);
-        arduino->setFlowControl(QSerialPort::NoFlowControl);
-        QObject::connect(arduino, SIGNAL(readyRead()), this, SLOT(readSerial()));
+    // Servo, mode and laser commands, latest wins per type with firmware acks
+    commands = new CommandChannel(arduino, this);
+    commands->setMaxRate(20);
+    commandLatencyLabel = new QLabel(this);
+    ui->statusbar->addPermanentWidget(commandLatencyLabel);
+    connect(commands, &CommandChannel::commandAcked, this, &MainWindow::updateCommandStatus);
+    updateCommandStatus();
+
+    // Port discovery and reconnects run on the device thread, so the window
+    // comes up right away and picks the Arduino up whenever it appears
+    connect(arduino, &DeviceSession::connectionChanged, this, &MainWindow::updateConnectionStatus);
+
+    // Live link quality, to see whether a higher sample rate actually gets through
+    linkStatsLabel = new QLabel(this);
+    ui->statusbar->addPermanentWidget(linkStatsLabel);
+    connect(arduino, &DeviceSession::statisticsChanged, this, &MainWindow::updateLinkStatistics);
+    if (transport.isEmpty()) {
+        ui->statusbar->showMessage("Searching for Arduino...");
+        arduino->connectToDevice(arduino_uno_vendorID, arduino_uno_productID);
     } else {
-        QMessageBox::warning(this, "Port error", "Couldn't find Arduino");
+        ui->statusbar->showMessage(QString("Connecting to %1...").arg(transport));
+        arduino->open(transport);
     }
 
     autoMode = false;  // Pastikan mode otomatis dinonaktifkan saat memulai
@@ -84,6 +212,11 @@ MainWindow::MainWindow(QWidget *parent)
     connect(resumeTimer, &QTimer::timeout, this, &MainWindow::resumeOperation);
 
     // Setup data update timer
+    batteryHistory = new BatteryHistoryModel(BatteryHistoryCapacity, this);
+    ui->historicalTableView->setModel(batteryHistory);
+    ui->historicalTableView->verticalHeader()->hide();
+    ui->historicalTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->historicalTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     dataUpdateTimer = new QTimer(this);
     connect(dataUpdateTimer, &QTimer::timeout, this, &MainWindow::updateHistoricalData);
     dataUpdateTimer->start(2000);  // Update setiap 2 detik
@@ -129,21 +262,6 @@ MainWindow::MainWindow(QWidget *parent)
         "}"
         );
 
-    // Setup battery serial port
-    batterySerial->setPortName("COM9");
-    batterySerial->setBaudRate(QSerialPort::Baud115200);
-    batterySerial->setDataBits(QSerialPort::Data8);
-    batterySerial->setParity(QSerialPort::NoParity);
-    batterySerial->setStopBits(QSerialPort::OneStop);
-    batterySerial->setFlowControl(QSerialPort::NoFlowControl);
-
-    if (batterySerial->open(QIODevice::ReadOnly)) {
-        connect(batterySerial, &QSerialPort::readyRead, this, &MainWindow::readBatteryData);
-        qDebug() << "Battery serial port opened successfully.";
-    } else {
-        qDebug() << "Failed to open battery serial port.";
-    }
-
     batteryTimer->start(2000);
 }
 
@@ -180,50 +298,212 @@ void MainWindow::updateSensorData() {
 }
 */
 
-void MainWindow::readBatteryData() {
-    QByteArray data = batterySerial->readAll();
-    batteryDataBuffer.append(data);
+void MainWindow::updateConnectionStatus(bool connected, const QString &portName) {
+    arduino_is_available = connected;
+    if (connected) {
+        radarSerial = portName;
+        ui->statusbar->showMessage(QString("Arduino connected on %1").arg(portName));
 
-    while (batteryDataBuffer.contains('\n')) {
-        int lineEnd = batteryDataBuffer.indexOf('\n');
-        QByteArray line = batteryDataBuffer.left(lineEnd);
-        batteryDataBuffer = batteryDataBuffer.mid(lineEnd + 1);
+        // The board resets when the port opens, put it back into our mode.
+        // The laser is fired from here, only for moving targets
+        commands->reset();
+        commands->send(CommandChannel::LaserModeCommand, "HOST_LASER");
+        if (autoMode) {
+            commands->send(CommandChannel::ModeCommand, "AUTO");
+        }
+    } else {
+        ui->statusbar->showMessage(QString("Lost Arduino on %1, reconnecting...").arg(portName));
+    }
+}
 
-        processBatteryData(QString::fromUtf8(line));
+void MainWindow::updateLinkStatistics(const LinkStatistics &stats) {
+    const LinkStatistics::Channel &radar = stats.channels[Telemetry::RadarMessage];
+    const LinkStatistics::Channel &battery = stats.channels[Telemetry::BatteryMessage];
+    quint64 expected = radar.received + radar.lost;
+    double lossPercent = expected ? 100.0 * radar.lost / expected : 0.0;
+
+    linkStatsLabel->setText(QString("Radar %1/s, %2% lost, jitter %3 ms | %4 kB/s | drift %5")
+                                .arg(radar.rate, 0, 'f', 0)
+                                .arg(lossPercent, 0, 'f', 1)
+                                .arg(radar.jitter / 1000.0, 0, 'f', 2)
+                                .arg(stats.byteRate / 1000.0, 0, 'f', 1)
+                                .arg(stats.clockFitted ? QString("%1 ppm").arg(stats.clockDrift, 0, 'f', 0) : QString("-")));
+    linkStatsLabel->setToolTip(QString("Radar: %1 received, %2 lost, %3 out of order\n"
+                                       "Battery: %4 received, %5 lost, jitter %6 ms\n"
+                                       "CRC errors: %7, bad frames/lines: %8\n"
+                                       "Dropped by the GUI queue: %9")
+                                   .arg(radar.received).arg(radar.lost).arg(radar.reordered)
+                                   .arg(battery.received).arg(battery.lost)
+                                   .arg(battery.jitter / 1000.0, 0, 'f', 2)
+                                   .arg(stats.crcErrors).arg(stats.framingErrors)
+                                   .arg(stats.dropped));
+
+    // Timeouts come without an ack, so they are picked up at this rate too
+    updateCommandStatus();
+}
+
+void MainWindow::updateCommandStatus() {
+    int latency = commands->lastLatency();
+    commandLatencyLabel->setText(QString("Command latency: %1, %2 timed out")
+                                     .arg(latency < 0 ? QString("-") : QString("%1 ms").arg(latency))
+                                     .arg(commands->timedOutCommands()));
+}
+
+void MainWindow::setRadarDisplay(int display) {
+    phosphor->setVisible(display == PhosphorDisplay);
+    detectionPoints->setVisible(display == PointDisplay);
+    occupancyItem->setVisible(display == OccupancyDisplay);
+    sweepContour->setVisible(display == ContourDisplay || display == FilledContourDisplay);
+    sweepContour->setFilled(display == FilledContourDisplay);
+    retentionBox->setEnabled(display == PointDisplay);
+    retentionModeBox->setEnabled(display == PointDisplay);
+    ui->graphicsView->viewport()->update();
+}
+
+void MainWindow::updateRetention() {
+    auto retention = PointCloudItem::Retention(retentionModeBox->currentData().toInt());
+    int amount = retentionBox->value();
+    detectionPoints->setRetention(retention, retention == PointCloudItem::RetainTime ? amount * 1000 : amount);
+}
+
+void MainWindow::exportRadarMap() {
+    QString path = QFileDialog::getSaveFileName(this, "Export radar map", "radarmap.csv", "CSV files (*.csv)");
+    if (path.isEmpty()) {
+        return;
     }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, "Export radar map", file.errorString());
+        return;
+    }
+    QTextStream out(&file);
+    radarGrid.writeCsv(out);
 }
 
-void MainWindow::readSerial() {
-    QByteArray data = arduino->readAll();
-    serialBuffer.append(QString::fromUtf8(data));
+void MainWindow::exportFrameTimings() {
+    QString path = QFileDialog::getSaveFileName(this, "Export frame timings", "frametimes.csv", "CSV files (*.csv)");
+    if (path.isEmpty()) {
+        return;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, "Export frame timings", file.errorString());
+        return;
+    }
+    QTextStream out(&file);
+    profiler.writeCsv(out);
+}
 
-    while (serialBuffer.contains('\n')) {
-        int lineEnd = serialBuffer.indexOf('\n');
-        QString line = serialBuffer.left(lineEnd).trimmed();
-        serialBuffer = serialBuffer.mid(lineEnd + 1);
+void MainWindow::setRenderStatsVisible(bool visible) {
+    renderStatsLabel->setVisible(visible);
+    if (visible) {
+        updateRenderStats();
+        renderStatsTimer->start(500);
+    } else {
+        renderStatsTimer->stop();
+    }
+}
 
-        if (line.startsWith("B,")) {
-            processBatteryData(line);
-        } else if (line.contains(',')) {
-            processRadarData(line);
-        } else if (line == "LASER_ACTIVATED") {
-            handleLaserActivation();
-        } else if (line == "LASER_DEACTIVATED") {
-            deactivateLaser();
-        }
+void MainWindow::updateRenderStats() {
+    QString text = QString("%1 fps  frame p50 %2  p95 %3  p99 %4  max %5 ms\n")
+                       .arg(profiler.framesPerSecond(), 0, 'f', 1)
+                       .arg(profiler.percentile(-1, 0.50), 0, 'f', 2)
+                       .arg(profiler.percentile(-1, 0.95), 0, 'f', 2)
+                       .arg(profiler.percentile(-1, 0.99), 0, 'f', 2)
+                       .arg(profiler.maximum(-1), 0, 'f', 2);
+    for (int stage = 0; stage < profiler.stageCount(); ++stage) {
+        text += QString("%1 p95 %2  max %3 ms\n")
+                    .arg(profiler.stageName(stage), -8)
+                    .arg(profiler.percentile(stage, 0.95), 0, 'f', 2)
+                    .arg(profiler.maximum(stage), 0, 'f', 2);
     }
+    text += QString("%1 points  %2 samples/s  %3 kpx/s repainted\n")
+                .arg(profiler.latest(PointsCounter))
+                .arg(profiler.rate(SamplesCounter), 0, 'f', 0)
+                .arg(profiler.rate(RepaintCounter) / 1000, 0, 'f', 0);
+    text += QString("queues: telemetry %1 (peak %2)  commands %3  dropped %4")
+                .arg(profiler.latest(TelemetryQueueCounter))
+                .arg(profiler.peak(TelemetryQueueCounter))
+                .arg(profiler.latest(CommandQueueCounter))
+                .arg(profiler.latest(DroppedCounter));
+    renderStatsLabel->setText(text);
+    renderStatsLabel->adjustSize();
 }
 
-void MainWindow::processRadarData(const QString &data) {
-    QStringList parts = data.split(',');
-    if (parts.size() == 2) {
-        float angle = parts[0].toFloat();
-        float distance = parts[1].toFloat();
+void MainWindow::setDisplayRate(int hz) {
+    frameTimer->start(1000 / qBound(1, hz, 240));
+}
 
-        updateDetectionPoint(angle, distance);
+void MainWindow::renderFrame() {
+    profiler.beginFrame();
+    profiler.setCounter(TelemetryQueueCounter, arduino->pendingMessages());
+    profiler.setCounter(CommandQueueCounter, commands->pendingCommands());
+    profiler.setCounter(DroppedCounter, qint64(arduino->droppedMessages()));
+
+    profiler.begin(PollStage);
+    arduino->poll();
+    profiler.end(PollStage);
+
+    // Every radar sample has its point by now, the readouts only show the latest
+    profiler.begin(ReadoutStage);
+    if (hasPendingRadar) {
+        hasPendingRadar = false;
+        updateRadarReadout(pendingRadar.angle, pendingRadar.distance);
+        setNeedleTarget(pendingRadar.angle);
+    }
+    profiler.end(ReadoutStage);
+
+    // Only what changed is repainted: new and expired points, the needle's
+    // sweep since the last frame, whatever faded
+    profiler.begin(DisplayStage);
+    RadarView *view = ui->graphicsView;
+    updateNeedle();
+
+    // Time-based retention expires points even when no samples come in.
+    // The cutoff is on the sample clock, wall clock steps would skew it.
+    qint64 now = arduino->hostTime();
+    detectionPoints->expire(now, radarSweeps.current());
+    view->markDirty(detectionPoints->flushUpdates());
+    movingPoints->expire(now, radarSweeps.current());
+    view->markDirty(movingPoints->flushUpdates());
+    view->markDirty(sweepContour->flushUpdates());
+    if (phosphor->isVisible()) {
+        view->markDirty(phosphor->decay());
+    }
 
-        if (distance < 50 && !laserActive) {
-            handleLaserActivation();
+    radarGrid.decay(now);
+    if (occupancyItem->isVisible()) {
+        view->markDirty(occupancyItem->refresh());
+    }
+    profiler.setCounter(RepaintCounter, view->flushDirty());
+    profiler.end(DisplayStage);
+    profiler.setCounter(PointsCounter, detectionPoints->count() + movingPoints->count());
+
+    if (hasPendingBattery) {
+        hasPendingBattery = false;
+        FrameProfiler::Scope scope(profiler, BatteryStage);
+        handleBatterySample(pendingBattery);
+    }
+}
+
+void MainWindow::handleRadarSample(const Telemetry::RadarSample &sample) {
+    profiler.addCount(SamplesCounter);
+    quint32 sweep = radarSweeps.update(sample.angle);
+    radarGrid.addSample(sample.angle, sample.distance);
+    bool moving = clutter.addSample(sample.angle, sample.distance, sample.timestamp, sweep);
+    addDetectionPoint(sample, sweep);
+    pendingRadar = sample;
+    hasPendingRadar = true;
+
+    // Only something that moved is a target, walls within range are not.
+    // The grid check keeps a single stray echo from firing the laser.
+    if (moving) {
+        movingPoints->append(PolarTransform::toScene(radarOrigin, sample.angle, sample.distance), sample.timestamp, sweep);
+        if (sample.distance < LaserRange && !laserActive) {
+            float nearest = radarGrid.nearestObstacle(sample.angle - LaserSectorWidth, sample.angle + LaserSectorWidth);
+            if (nearest >= 0 && nearest < LaserRange) {
+                handleLaserActivation();
+            }
         }
     }
 }
@@ -233,38 +513,25 @@ void MainWindow::updateCurrentTime() {
     ui->currentTimeLabel_3->setText(currentTime.toString("hh:mm:ss"));
 }
 
-void MainWindow::processBatteryData(const QString &data) {
-    QStringList parts = data.split(',');
-    if (parts.size() == 6) {
-        float busVoltage = parts[1].toFloat();
-        float shuntVoltage = parts[2].toFloat();
-        float loadVoltage = parts[3].toFloat();
-        float current = parts[4].toFloat();
-        float power = parts[5].toFloat();
-
-        // Update real-time labels
-        ui->busVoltageLabel->setText(QString::number(busVoltage, 'f', 2) + " V");
-        ui->shuntVoltageLabel->setText(QString::number(shuntVoltage, 'f', 2) + " mV");
-        ui->loadVoltageLabel->setText(QString::number(loadVoltage, 'f', 2) + " V");
-        ui->currentLabel->setText(QString::number(current, 'f', 2) + " mA");
-        ui->powerLabel->setText(QString::number(power, 'f', 2) + " mW");
-
-        // Add to historical data
-        QDateTime currentTime = QDateTime::currentDateTime();
-        QString timeString = currentTime.toString("hh:mm:ss");
-        QString historicalEntry = QString("%1,%2,%3,%4,%5,%6").arg(timeString)
-                                      .arg(busVoltage)
-                                      .arg(shuntVoltage)
-                                      .arg(loadVoltage)
-                                      .arg(current)
-                                      .arg(power);
-        historicalData.prepend(historicalEntry);
-        if (historicalData.size() > 10) {
-            historicalData.removeLast();
-        }
-
-        updateBatteryProgressBar(power);
-    }
+void MainWindow::handleBatterySample(const Telemetry::BatterySample &sample) {
+    float busVoltage = sample.busVoltage;
+    float shuntVoltage = sample.shuntVoltage;
+    float loadVoltage = sample.loadVoltage;
+    float current = sample.current;
+    float power = sample.power;
+
+    // Update real-time labels
+    ui->busVoltageLabel->setText(QString::number(busVoltage, 'f', 2) + " V");
+    ui->shuntVoltageLabel->setText(QString::number(shuntVoltage, 'f', 2) + " mV");
+    ui->loadVoltageLabel->setText(QString::number(loadVoltage, 'f', 2) + " V");
+    ui->currentLabel->setText(QString::number(current, 'f', 2) + " mA");
+    ui->powerLabel->setText(QString::number(power, 'f', 2) + " mW");
+
+    // The history table takes the latest one every 2 s
+    latestBattery = sample;
+    hasLatestBattery = true;
+
+    updateBatteryProgressBar(power);
 }
 
 void MainWindow::updateBatteryProgressBar(float power) {
@@ -278,51 +545,10 @@ void MainWindow::updateBatteryProgressBar(float power) {
 }
 
 void MainWindow::updateHistoricalData() {
-    for (int i = 10; i > 1; --i) {
-        QLabel* timeLabel = findChild<QLabel*>(QString("historicalTimeLabel%1_2").arg(i));
-        QLabel* busVoltageLabel = findChild<QLabel*>(QString("historicalBusVoltageLabel%1_2").arg(i));
-        QLabel* shuntVoltageLabel = findChild<QLabel*>(QString("historicalShuntVoltageLabel%1_2").arg(i));
-        QLabel* loadVoltageLabel = findChild<QLabel*>(QString("historicalLoadVoltageLabel%1_2").arg(i));
-        QLabel* currentLabel = findChild<QLabel*>(QString("historicalCurrentLabel%1_2").arg(i));
-        QLabel* powerLabel = findChild<QLabel*>(QString("historicalPowerLabel%1_2").arg(i));
-
-        QLabel* prevTimeLabel = findChild<QLabel*>(QString("historicalTimeLabel%1_2").arg(i-1));
-        QLabel* prevBusVoltageLabel = findChild<QLabel*>(QString("historicalBusVoltageLabel%1_2").arg(i-1));
-        QLabel* prevShuntVoltageLabel = findChild<QLabel*>(QString("historicalShuntVoltageLabel%1_2").arg(i-1));
-        QLabel* prevLoadVoltageLabel = findChild<QLabel*>(QString("historicalLoadVoltageLabel%1_2").arg(i-1));
-        QLabel* prevCurrentLabel = findChild<QLabel*>(QString("historicalCurrentLabel%1_2").arg(i-1));
-        QLabel* prevPowerLabel = findChild<QLabel*>(QString("historicalPowerLabel%1_2").arg(i-1));
-
-        if (timeLabel && busVoltageLabel && shuntVoltageLabel && loadVoltageLabel && currentLabel && powerLabel &&
-            prevTimeLabel && prevBusVoltageLabel && prevShuntVoltageLabel && prevLoadVoltageLabel && prevCurrentLabel && prevPowerLabel) {
-            timeLabel->setText(prevTimeLabel->text());
-            busVoltageLabel->setText(prevBusVoltageLabel->text());
-            shuntVoltageLabel->setText(prevShuntVoltageLabel->text());
-            loadVoltageLabel->setText(prevLoadVoltageLabel->text());
-            currentLabel->setText(prevCurrentLabel->text());
-            powerLabel->setText(prevPowerLabel->text());
-        }
-    }
-
-    if (!historicalData.isEmpty()) {
-        QStringList data = historicalData.first().split(',');
-        if (data.size() == 6) {
-            QLabel* timeLabel = findChild<QLabel*>("historicalTimeLabel1_2");
-            QLabel* busVoltageLabel = findChild<QLabel*>("historicalBusVoltageLabel1_2");
-            QLabel* shuntVoltageLabel = findChild<QLabel*>("historicalShuntVoltageLabel1_2");
-            QLabel* loadVoltageLabel = findChild<QLabel*>("historicalLoadVoltageLabel1_2");
-            QLabel* currentLabel = findChild<QLabel*>("historicalCurrentLabel1_2");
-            QLabel* powerLabel = findChild<QLabel*>("historicalPowerLabel1_2");
-
-            if (timeLabel && busVoltageLabel && shuntVoltageLabel && loadVoltageLabel && currentLabel && powerLabel) {
-                timeLabel->setText(data[0]);
-                busVoltageLabel->setText(data[1] + " V");
-                shuntVoltageLabel->setText(data[2] + " mV");
-                loadVoltageLabel->setText(data[3] + " V");
-                currentLabel->setText(data[4] + " mA");
-                powerLabel->setText(data[5] + " mW");
-            }
-        }
+    FrameProfiler::Scope scope(profiler, HistoryStage);
+    if (hasLatestBattery) {
+        hasLatestBattery = false;
+        batteryHistory->append(latestBattery);
     }
 }
 
@@ -346,7 +572,7 @@ void MainWindow::handleLaserActivation() {
 
         setSliderEnabled(false);
         updateLaserStatus("Laser: On");
-        arduino->write("LASER_ON\n");
+        commands->send(CommandChannel::LaserCommand, "LASER_ON");
         laserTimer->start(2000);
     }
 }
@@ -354,7 +580,7 @@ void MainWindow::handleLaserActivation() {
 void MainWindow::deactivateLaser() {
     laserActive = false;
     updateLaserStatus("Laser: Off");
-    arduino->write("LASER_OFF\n");
+    commands->send(CommandChannel::LaserCommand, "LASER_OFF");
     laserTimer->stop();
     resumeTimer->start(0);  // Timer untuk melanjutkan operasi normal setelah 1 detik
 }
@@ -365,9 +591,9 @@ void MainWindow::resumeOperation() {
     if (previousAutoMode) {
         autoMode = true;
         autoTimer->start(50);
-        arduino->write("AUTO\n");
+        commands->send(CommandChannel::ModeCommand, "AUTO");
     } else {
-        arduino->write("MANUAL\n");
+        commands->send(CommandChannel::ModeCommand, "MANUAL");
     }
 
     setSliderEnabled(previousSliderState);
@@ -383,9 +609,9 @@ void MainWindow::updateLaserStatus(const QString &status) {
     ui->textEdit->setPlainText(status);
 }
 
-void MainWindow::updateServo(QString command) {
-    if (arduino->isWritable()) {
-        arduino->write(command.toUtf8());
+void MainWindow::updateServo(int angle) {
+    if (arduino->isOpen()) {
+        commands->send(CommandChannel::ServoCommand, QByteArray::number(angle));
     } else {
         qDebug() << "Couldn't write to serial!";
     }
@@ -410,80 +636,104 @@ void MainWindow::updateServoAuto() {
         }
     }
 
-    updateServo(QString::number(angle) + "\n");
+    updateServo(angle);
     ui->verticalSlider->setValue(angle);
 }
 
-void MainWindow::updateDetectionPoint(float angle, float distance) {
-    qDebug() << "Updating detection point at angle:" << angle << "distance:" << distance;
+void MainWindow::addDetectionPoint(const Telemetry::RadarSample &sample, quint32 sweep) {
+    QPointF point = PolarTransform::toScene(radarOrigin, sample.angle, sample.distance);
+    detectionPoints->append(point, sample.timestamp, sweep);
+    sweepContour->addSample(sample.angle, sample.distance, sweep);
+    phosphor->plot(point);
+}
 
+void MainWindow::updateRadarReadout(float angle, float distance) {
     ui->angleLabel->setText(QString("%1°").arg(angle, 0, 'f', 1));
     ui->rangeLabel->setText(QString("%1 cm").arg(distance, 0, 'f', 1));
+}
 
-    float radAngle = qDegreesToRadians(angle);
-    float x = distance * qCos(radAngle);
-    float y = distance * qSin(radAngle);
+void MainWindow::setNeedleTarget(float angle) {
+    // Glide from wherever the needle is now over the time the last new
+    // angle took to arrive, so it keeps moving between samples at any rate
+    qint64 now = needleClock.elapsed();
+    float shown = needleAngle(now);
+    needleDuration = qMin(now - needleStart, qint64(MaxNeedleGlide));
+    needleStart = now;
+    needleFrom = shown;
+    needleTo = angle;
+}
 
-    QGraphicsRectItem* point = scene->addRect(505 + x, 495 - y, 3, 3, QPen(Qt::red), QBrush(Qt::red));
-    detectionPoints.append(point);
+float MainWindow::needleAngle(qint64 now) const {
+    if (needleDuration <= 0 || now >= needleStart + needleDuration) {
+        return needleTo;
+    }
+    float t = float(now - needleStart) / needleDuration;
+    return needleFrom + (needleTo - needleFrom) * t;
+}
 
-    float t_up = radAngle + angleOffset;
-    float t_lo = radAngle - angleOffset;
-    QPolygonF newTriangle;
-    newTriangle.append(QPointF(r * qCos(t_up) + 505, -r * qSin(t_up) + 495));
-    newTriangle.append(QPointF(505, 495));
-    newTriangle.append(QPointF(r * qCos(t_lo) + 505, -r * qSin(t_lo) + 495));
-    needle->setPolygon(newTriangle);
+void MainWindow::updateNeedle() {
+    // Scene y points down, so counter-clockwise on screen is negative
+    qreal rotation = -needleAngle(needleClock.elapsed());
+    if (needle->rotation() == rotation) {
+        return;
+    }
 
-    clearOldDetectionPoints();
+    // Repaint the wedge from the old needle to the new one, edges included
+    float halfWidth = float(qRadiansToDegrees(PolarTransform::NeedleHalfWidth));
+    float from = float(-needle->rotation());
+    float to = float(-rotation);
+    ui->graphicsView->markDirtySector(qMin(from, to) - halfWidth, qMax(from, to) + halfWidth, r * needle->scale());
+    needle->setRotation(rotation);
 }
 
-void MainWindow::clearOldDetectionPoints() {
-    while (detectionPoints.size() > 50) {
-        QGraphicsRectItem* point = detectionPoints.takeFirst();
-        scene->removeItem(point);
-        delete point;
-    }
+QPolygonF MainWindow::needlePolygon(float angle) const {
+    QPolygonF polygon;
+    polygon.reserve(3);
+    polygon.append(PolarTransform::toScene(radarOrigin, PolarTransform::needleUpper(angle), r));
+    polygon.append(radarOrigin);
+    polygon.append(PolarTransform::toScene(radarOrigin, PolarTransform::needleLower(angle), r));
+    return polygon;
 }
 
+
 void MainWindow::on_button0_clicked() {
     if (!autoMode) {
-        updateServo("0\n");
+        updateServo(0);
         ui->verticalSlider->setValue(0);
     }
 }
 
 void MainWindow::on_button45_clicked() {
     if (!autoMode) {
-        updateServo("45\n");
+        updateServo(45);
         ui->verticalSlider->setValue(45);
     }
 }
 
 void MainWindow::on_button90_clicked() {
     if (!autoMode) {
-        updateServo("90\n");
+        updateServo(90);
         ui->verticalSlider->setValue(90);
     }
 }
 
 void MainWindow::on_button135_clicked() {
     if (!autoMode) {
-        updateServo("135\n");
+        updateServo(135);
         ui->verticalSlider->setValue(135);
     }
 }
 
 void MainWindow::on_button180_clicked() {
     if (!autoMode) {
-        updateServo("180\n");
+        updateServo(180);
         ui->verticalSlider->setValue(180);
     }
 }
 
 void MainWindow::on_verticalSlider_valueChanged(int value) {
     if (!autoMode && !laserActive) {
-        updateServo(QString::number(value) + "\n");
+        updateServo(value);
     }
 }
 
@@ -498,24 +748,18 @@ void MainWindow::on_button_auto_clicked() {
         autoTimer->start(50);
         ui->button_auto->setText("Stop Auto");
         setSliderEnabled(false);
-        arduino->write("AUTO\n");
+        commands->send(CommandChannel::ModeCommand, "AUTO");
     } else {
         autoTimer->stop();
         ui->button_auto->setText("Start Auto");
         setSliderEnabled(true);
-        arduino->write("MANUAL\n");
+        commands->send(CommandChannel::ModeCommand, "MANUAL");
     }
 }
 
 MainWindow::~MainWindow() {
-    if (arduino->isOpen()) {
-        arduino->close();
-    }
     if (serial->isOpen()) {
         serial->close();
     }
-    if (batterySerial->isOpen()) {
-        batterySerial->close();
-    }
     delete ui;
 }
@@ -11,6 +11,20 @@
 #include <QtWidgets>
 #include <QtGui>
 #include <QtMath>
+#include "batteryhistorymodel.h"
+#include "cluttermodel.h"
+#include "commandchannel.h"
+#include "devicesession.h"
+#include "frameprofiler.h"
+#include "occupancygrid.h"
+#include "occupancygriditem.h"
+#include "phosphoritem.h"
+#include "pointclouditem.h"
+#include "radarview.h"
+#include "polartransform.h"
+#include "sweepcontouritem.h"
+#include "sweeptracker.h"
+#include "telemetryprotocol.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -21,7 +35,8 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    // transport is a Transport::create() spec, empty finds the Arduino by USB ids
+    MainWindow(const QString &transport = QString(), QWidget *parent = nullptr);
     ~MainWindow();
 
 private slots:
@@ -32,11 +47,20 @@ private slots:
     void turnRight();
     void updateSensorData();
 */
-    void readBatteryData();
-    void updateServo(QString command);
-    void readSerial();
-    void processRadarData(const QString &data);
-    void processBatteryData(const QString &data);
+    void updateServo(int angle);
+    void updateConnectionStatus(bool connected, const QString &portName);
+    void updateLinkStatistics(const LinkStatistics &stats);
+    void updateCommandStatus();
+    void setDisplayRate(int hz);
+    void renderFrame();
+    void setRadarDisplay(int display);
+    void updateRetention();
+    void exportRadarMap();
+    void exportFrameTimings();
+    void setRenderStatsVisible(bool visible);
+    void updateRenderStats();
+    void handleRadarSample(const Telemetry::RadarSample &sample);
+    void handleBatterySample(const Telemetry::BatterySample &sample);
     void updateBatteryProgressBar(float power);
     void updateHistoricalData(); //(float busVoltage, float shuntVoltage, float loadVoltage, float current, float power);
     void on_button0_clicked();
@@ -47,8 +71,8 @@ private slots:
     void on_verticalSlider_valueChanged(int value);
     void on_button_auto_clicked();
     void updateServoAuto();
-    void clearOldDetectionPoints();
-    void updateDetectionPoint(float angle, float distance);
+    void addDetectionPoint(const Telemetry::RadarSample &sample, quint32 sweep);
+    void updateRadarReadout(float angle, float distance);
     void handleLaserActivation();
     void deactivateLaser();
     void resumeOperation();
@@ -57,35 +81,101 @@ private slots:
     void updateCurrentTime();
 
 private:
+    enum RadarDisplay {
+        PhosphorDisplay,
+        PointDisplay,
+        OccupancyDisplay,
+        ContourDisplay,
+        FilledContourDisplay
+    };
+
+    // Registered with the profiler in this order
+    enum ProfileStage {
+        PollStage,
+        ReadoutStage,
+        DisplayStage,
+        BatteryStage,
+        HistoryStage,
+        PaintStage
+    };
+    enum ProfileCounter {
+        SamplesCounter,
+        PointsCounter,
+        TelemetryQueueCounter,
+        CommandQueueCounter,
+        DroppedCounter,
+        RepaintCounter
+    };
+
+    // A moving target closer than this fires the laser, once the grid
+    // confirms an obstacle that close in the sector the servo points at
+    static constexpr float LaserRange = 50.0f;
+    static constexpr float LaserSectorWidth = 2.0f;
+    // Hard limit on retained points, about 26 s at 10 kHz
+    static const int PointCapacity = 1 << 18;
+    static const int MovingCapacity = 1 << 14;
+
+    // Longest the needle takes to catch up with a new angle
+    static const int MaxNeedleGlide = 200;  // ms
+    // One row every 2 s, about 5.5 hours
+    static const int BatteryHistoryCapacity = 10000;
+
+    QPolygonF needlePolygon(float angle) const;
+    void setNeedleTarget(float angle);
+    float needleAngle(qint64 now) const;
+    void updateNeedle();
+
     Ui::MainWindow *ui;
     QSerialPort *serial;
-    QSerialPort *batterySerial;
     QTimer *batteryTimer;
     QProgressBar *powerProgressBar;
     float maxExpectedPower;
-    QByteArray batteryDataBuffer;
-    QString serialBuffer;
-    QStringList historicalData;
+    BatteryHistoryModel *batteryHistory;
+    Telemetry::BatterySample latestBattery;
+    bool hasLatestBattery;
     QTimer *dataUpdateTimer;
 
     QGraphicsScene *scene;
-    QPixmap pix;
     QGraphicsItem *rect;
     float currAngle;
     const float r;
-    const float angleOffset;
-    float t_up;
-    float t_lo;
-    QPolygonF triangle;
+    const QPointF radarOrigin;
     QGraphicsPolygonItem* needle;
-    QSerialPort *arduino;
+    QElapsedTimer needleClock;
+    float needleFrom;
+    float needleTo;
+    qint64 needleStart;
+    qint64 needleDuration;
+    DeviceSession *arduino;
+    CommandChannel *commands;
+    QLabel *commandLatencyLabel;
+    QLabel *linkStatsLabel;
+    QTimer *frameTimer;
+    Telemetry::RadarSample pendingRadar;
+    Telemetry::BatterySample pendingBattery;
+    bool hasPendingRadar;
+    bool hasPendingBattery;
     static const quint16 arduino_uno_vendorID = 9025;
     static const quint16 arduino_uno_productID = 67;
     QString radarSerial;
     bool arduino_is_available;
     QByteArray serialData;
     QString servoSetting;
-    QList<QGraphicsRectItem*> detectionPoints;
+    PointCloudItem *detectionPoints;
+    PhosphorItem *phosphor;
+    OccupancyGrid radarGrid;
+    OccupancyGridItem *occupancyItem;
+    SweepContourItem *sweepContour;
+    ClutterModel clutter;
+    PointCloudItem *movingPoints;
+    QComboBox *radarDisplayBox;
+    SweepTracker radarSweeps;
+    QSpinBox *retentionBox;
+    QComboBox *retentionModeBox;
+    QDoubleSpinBox *rangeBox;
+    FrameProfiler profiler;
+    QLabel *renderStatsLabel;
+    QTimer *renderStatsTimer;
     QTimer *autoTimer;
     bool laserActive;
     QTimer *laserTimer;
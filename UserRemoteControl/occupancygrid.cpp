@@ -0,0 +1,110 @@
+#include "occupancygrid.h"
+#include <QTextStream>
+#include <QtMath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+OccupancyGrid::OccupancyGrid(int angleBins, float binSize, float maxRange)
+    : angles(qMax(1, angleBins))
+    , ranges(qMax(1, qCeil(maxRange / binSize)))
+    , size(binSize)
+    , cells(angles * ranges, 0)
+    , lastDecay(-1)
+    , decayInterval(100000)
+{
+}
+
+void OccupancyGrid::clear() {
+    cells.fill(0);
+}
+
+int OccupancyGrid::angleBin(float angle) const {
+    return qBound(0, qRound(angle), angles - 1);
+}
+
+void OccupancyGrid::addSample(float angle, float distance) {
+    qint8 *row = cells.data() + angleBin(angle) * ranges;
+    int hit = int(distance / size);
+
+    // No echo within range means everything up to max range is free
+    int freeBins = qBound(0, hit, ranges);
+    for (int i = 0; i < freeBins; ++i) {
+        row[i] = qint8(qMax(row[i] + MissEvidence, -MaxEvidence));
+    }
+    if (hit >= 0 && hit < ranges) {
+        row[hit] = qint8(qMin(row[hit] + HitEvidence, int(MaxEvidence)));
+    }
+}
+
+void OccupancyGrid::decay(qint64 now) {
+    if (lastDecay < 0 || now < lastDecay) {
+        lastDecay = now;
+        return;
+    }
+    qint64 steps = (now - lastDecay) / decayInterval;
+    if (steps == 0) {
+        return;
+    }
+    lastDecay += steps * decayInterval;
+
+    // Saturating byte arithmetic: v - step where that stays above zero,
+    // v + step where that stays below, zero in between
+    qint8 step = qint8(qMin<qint64>(steps, MaxEvidence));
+    qint8 *cell = cells.data();
+    int n = cells.size();
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i amount = _mm_set1_epi8(step);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cell + i));
+        __m128i down = _mm_subs_epi8(v, amount);
+        __m128i up = _mm_adds_epi8(v, amount);
+        down = _mm_and_si128(down, _mm_cmpgt_epi8(down, zero));
+        up = _mm_and_si128(up, _mm_cmpgt_epi8(zero, up));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(cell + i), _mm_or_si128(down, up));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        int down = cell[i] - step;
+        int up = cell[i] + step;
+        cell[i] = qint8(down > 0 ? down : (up < 0 ? up : 0));
+    }
+}
+
+float OccupancyGrid::probability(int angleBin, int rangeBin) const {
+    return 1.0f / (1.0f + qExp(-evidence(angleBin, rangeBin) / 10.0f));
+}
+
+float OccupancyGrid::nearestObstacle(float fromAngle, float toAngle) const {
+    int first = angleBin(qMin(fromAngle, toAngle));
+    int last = angleBin(qMax(fromAngle, toAngle));
+
+    // Rows are contiguous, and each scan stops at the nearest hit so far
+    int nearest = ranges;
+    for (int a = first; a <= last; ++a) {
+        const qint8 *row = cells.constData() + a * ranges;
+        for (int r = 0; r < nearest; ++r) {
+            if (row[r] >= OccupiedThreshold) {
+                nearest = r;
+                break;
+            }
+        }
+    }
+    return nearest < ranges ? nearest * size : -1.0f;
+}
+
+void OccupancyGrid::writeCsv(QTextStream &out) const {
+    out << "angle,range_cm,probability\n";
+    for (int a = 0; a < angles; ++a) {
+        for (int r = 0; r < ranges; ++r) {
+            if (isOccupied(a, r)) {
+                out << a << ',' << (r + 0.5f) * size << ',' << probability(a, r) << '\n';
+            }
+        }
+    }
+}
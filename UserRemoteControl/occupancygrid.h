@@ -0,0 +1,60 @@
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class QTextStream;
+
+// What the radar knows about its surroundings: one row of range bins per
+// degree of servo angle, stored as a single contiguous array of log-odds
+// evidence. A sample clears the bins its ping passed through and marks the
+// bin it echoed from. Evidence decays back to "unknown" over time, so
+// obstacles that went away are forgotten. A whole grid is 36 KB, so sector
+// queries stay in cache and take microseconds.
+class OccupancyGrid
+{
+public:
+    // Log-odds in tenths, clamped so new evidence can always overturn old
+    static const qint8 HitEvidence = 9;     // p(occupied | echo) ~ 0.71
+    static const qint8 MissEvidence = -4;   // p(occupied | passed through) ~ 0.40
+    static const qint8 MaxEvidence = 50;
+    static const qint8 OccupiedThreshold = 5;
+
+    OccupancyGrid(int angleBins = 181, float binSize = 2.0f, float maxRange = 400.0f);
+
+    int angleBins() const { return angles; }
+    int rangeBins() const { return ranges; }
+    float binSize() const { return size; }
+
+    void clear();
+    void addSample(float angle, float distance);
+
+    // Moves every cell one step towards unknown per decay interval since the
+    // last call. now is in us, on the same clock as the sample timestamps.
+    void decay(qint64 now);
+    void setDecayInterval(int ms) { decayInterval = qMax(1, ms) * qint64(1000); }
+
+    qint8 evidence(int angleBin, int rangeBin) const { return cells[angleBin * ranges + rangeBin]; }
+    bool isOccupied(int angleBin, int rangeBin) const { return evidence(angleBin, rangeBin) >= OccupiedThreshold; }
+    float probability(int angleBin, int rangeBin) const;
+
+    // Distance in cm to the closest occupied bin between the two angles
+    // (inclusive), or a negative value if the sector is clear
+    float nearestObstacle(float fromAngle, float toAngle) const;
+
+    // angle, range (cm), probability for every occupied bin
+    void writeCsv(QTextStream &out) const;
+
+private:
+    int angleBin(float angle) const;
+
+    int angles;
+    int ranges;
+    float size;
+    QVector<qint8> cells;
+    qint64 lastDecay;
+    qint64 decayInterval;
+};
+
+#endif // OCCUPANCYGRID_H
@@ -0,0 +1,56 @@
+#include "occupancygriditem.h"
+#include <QPainter>
+#include "polartransform.h"
+
+OccupancyGridItem::OccupancyGridItem(const OccupancyGrid *grid, const QPointF &origin, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , grid(grid)
+    , origin(origin)
+    , color(Qt::red)
+{
+    qreal reach = grid->rangeBins() * grid->binSize() + CellSize;
+    bounds = QRectF(origin.x() - reach, origin.y() - reach, 2 * reach, reach + CellSize);
+}
+
+void OccupancyGridItem::setColor(const QColor &color) {
+    this->color = color;
+    update();
+}
+
+QRectF OccupancyGridItem::refresh() {
+    QRectF before = cellBounds;
+    cellBounds = QRectF();
+    strong.clear();
+    weak.clear();
+
+    for (int a = 0; a < grid->angleBins(); ++a) {
+        PolarTransform::Direction direction = PolarTransform::beam(float(a));
+        for (int r = 0; r < grid->rangeBins(); ++r) {
+            qint8 evidence = grid->evidence(a, r);
+            if (evidence < OccupancyGrid::OccupiedThreshold) {
+                continue;
+            }
+            float range = (r + 0.5f) * grid->binSize();
+            QRectF cell(PolarTransform::toScene(origin, direction, range), QSizeF(CellSize, CellSize));
+            (evidence >= StrongEvidence ? strong : weak).append(cell);
+            cellBounds |= cell;
+        }
+    }
+
+    QRectF changed = before | cellBounds;
+    if (changed.isNull()) {
+        return QRectF();
+    }
+    update(changed);
+    return mapRectToScene(changed);
+}
+
+void OccupancyGridItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) {
+    painter->setPen(Qt::NoPen);
+    QColor faint = color;
+    faint.setAlphaF(0.4f);
+    painter->setBrush(faint);
+    painter->drawRects(weak.constData(), weak.size());
+    painter->setBrush(color);
+    painter->drawRects(strong.constData(), strong.size());
+}
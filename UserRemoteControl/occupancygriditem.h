@@ -0,0 +1,37 @@
+#ifndef OCCUPANCYGRIDITEM_H
+#define OCCUPANCYGRIDITEM_H
+
+#include <QGraphicsItem>
+#include <QVector>
+#include "occupancygrid.h"
+
+// Draws the occupied bins of an OccupancyGrid around the radar origin,
+// 1 scene unit per cm. refresh() rebuilds the cell rectangles from the grid
+// once per frame and paint() draws them in two drawRects() calls, strong
+// and weak evidence.
+class OccupancyGridItem : public QGraphicsItem
+{
+public:
+    OccupancyGridItem(const OccupancyGrid *grid, const QPointF &origin, QGraphicsItem *parent = nullptr);
+
+    void setColor(const QColor &color);
+    // Returns the scene rect that changed
+    QRectF refresh();
+
+    QRectF boundingRect() const override { return bounds; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    static const int CellSize = 4;
+    static const qint8 StrongEvidence = 30;
+
+    const OccupancyGrid *grid;
+    QPointF origin;
+    QRectF bounds;
+    QRectF cellBounds;  // of the cells drawn, within bounds
+    QColor color;
+    QVector<QRectF> strong;
+    QVector<QRectF> weak;
+};
+
+#endif // OCCUPANCYGRIDITEM_H
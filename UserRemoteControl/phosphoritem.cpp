@@ -0,0 +1,116 @@
+#include "phosphoritem.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QtMath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Scales every byte of the premultiplied pixels by factor / 65536, rounding
+// down, so any non-zero channel loses at least 1 per pass. Premultiplied
+// colour fades uniformly with its alpha.
+void decayPixels(quint32 *pixels, qsizetype count, quint16 factor) {
+    uchar *p = reinterpret_cast<uchar *>(pixels);
+    qsizetype bytes = count * 4;
+    qsizetype i = 0;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i scale = _mm_set1_epi16(short(factor));
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        __m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(v, zero), scale);
+        __m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(v, zero), scale);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < bytes; ++i) {
+        p[i] = uchar((p[i] * quint32(factor)) >> 16);
+    }
+}
+
+}
+
+PhosphorItem::PhosphorItem(const QSize &size, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , image(size, QImage::Format_ARGB32_Premultiplied)
+    , pixel(qPremultiply(qRgb(255, 0, 0)))
+    , persistence(3000)
+    , pendingTime(0)
+    , framesUntilDark(0)
+{
+    image.fill(Qt::transparent);
+    clock.start();
+
+    // paint() only copies what is exposed
+    setFlag(ItemUsesExtendedStyleOption);
+}
+
+void PhosphorItem::setPersistence(int ms) {
+    persistence = qMax(1, ms);
+}
+
+void PhosphorItem::setColor(const QColor &color) {
+    pixel = qPremultiply(color.rgba());
+}
+
+void PhosphorItem::plot(const QPointF &point) {
+    QRect rect = QRect(point.toPoint(), QSize(PointSize, PointSize)) & image.rect();
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(image.scanLine(y));
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            line[x] = pixel;
+        }
+    }
+    dirty |= rect;
+    lit |= rect;
+    framesUntilDark = 255;
+}
+
+void PhosphorItem::clear() {
+    image.fill(Qt::transparent);
+    framesUntilDark = 0;
+    lit = QRect();
+    update();
+}
+
+QRectF PhosphorItem::decay() {
+    pendingTime += clock.nsecsElapsed() / 1000;
+    clock.restart();
+
+    if (framesUntilDark == 0) {
+        pendingTime = 0;
+        lit = QRect();
+        return QRectF();
+    }
+
+    // Fading in tiny steps would round away, wait until a step is worth it
+    double factor = qPow(0.1, pendingTime / (persistence * 1000.0));
+    if (factor > 254.0 / 256.0) {
+        if (dirty.isNull()) {
+            return QRectF();
+        }
+        QRectF changed = mapRectToScene(QRectF(dirty));
+        update(dirty);
+        dirty = QRect();
+        return changed;
+    }
+    pendingTime = 0;
+
+    // Whole rows are contiguous, so fade the band of rows that are lit
+    decayPixels(reinterpret_cast<quint32 *>(image.scanLine(lit.top())),
+                qsizetype(lit.height()) * image.bytesPerLine() / 4,
+                quint16(qBound(0.0, factor * 65536.0, 65535.0)));
+    --framesUntilDark;
+    dirty = QRect();
+    update(lit);
+    return mapRectToScene(QRectF(lit));
+}
+
+void PhosphorItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) {
+    painter->drawImage(option->exposedRect, image, option->exposedRect);
+}
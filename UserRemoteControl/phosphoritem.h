@@ -0,0 +1,47 @@
+#ifndef PHOSPHORITEM_H
+#define PHOSPHORITEM_H
+
+#include <QElapsedTimer>
+#include <QGraphicsItem>
+#include <QImage>
+
+// PPI-scope style persistence. Detections are plotted straight into an
+// offscreen premultiplied ARGB image, and once per frame decay() scales every
+// pixel towards transparent with an SSE2 kernel. The image is drawn over the
+// radar background, so older detections fade out instead of vanishing at a
+// fixed count, and the cost per frame is the same however many points were
+// plotted, up to the rows that are lit at all.
+class PhosphorItem : public QGraphicsItem
+{
+public:
+    explicit PhosphorItem(const QSize &size, QGraphicsItem *parent = nullptr);
+
+    // Time for a detection to fade to a tenth of its brightness
+    void setPersistence(int ms);
+    void setColor(const QColor &color);
+
+    void plot(const QPointF &point);
+    void clear();
+
+    // Fades by the time since the last call and schedules a repaint if
+    // anything is lit. Returns the scene rect that changed.
+    QRectF decay();
+
+    QRectF boundingRect() const override { return QRectF(QPointF(0, 0), image.size()); }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    // Same footprint as the point cloud
+    static const int PointSize = 4;
+
+    QImage image;
+    quint32 pixel;
+    int persistence;
+    QElapsedTimer clock;
+    qint64 pendingTime;    // us not yet applied as decay
+    int framesUntilDark;   // each decay pass takes at least 1 off every channel
+    QRect dirty;
+    QRect lit;             // everything plotted since the image was last dark
+};
+
+#endif // PHOSPHORITEM_H
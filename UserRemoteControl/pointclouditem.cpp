@@ -0,0 +1,101 @@
+#include "pointclouditem.h"
+#include <QPainter>
+
+PointCloudItem::PointCloudItem(int capacity, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , first(0)
+    , size(0)
+    , mode(RetainSweeps)
+    , amount(2)
+    , brush(Qt::red)
+{
+    setCapacity(capacity);
+}
+
+void PointCloudItem::setCapacity(int capacity) {
+    capacity = qMax(1, capacity);
+    rects.fill(QRectF(), capacity);
+    timestamps.fill(0, capacity);
+    sweeps.fill(0, capacity);
+    clear();
+}
+
+void PointCloudItem::setBrush(const QBrush &brush) {
+    this->brush = brush;
+    update();
+}
+
+void PointCloudItem::setRetention(Retention retention, int amount) {
+    // Takes effect on the next expire(), points already dropped stay dropped
+    mode = retention;
+    this->amount = qMax(1, amount);
+}
+
+void PointCloudItem::append(const QPointF &point, qint64 timestamp, quint32 sweep) {
+    QRectF rect(point, QSizeF(PointSize, PointSize));
+
+    // Rarely grows, only when a point lands outside everything seen so far
+    if (!bounds.contains(rect)) {
+        prepareGeometryChange();
+        bounds = bounds.isNull() ? rect : bounds.united(rect);
+    }
+
+    if (size == rects.size()) {
+        dropOldest();
+    }
+    int index = (first + size) % rects.size();
+    rects[index] = rect;
+    timestamps[index] = timestamp;
+    sweeps[index] = sweep;
+    ++size;
+    dirty |= rect;
+}
+
+void PointCloudItem::expire(qint64 now, quint32 sweep) {
+    if (mode == RetainTime) {
+        qint64 cutoff = now - qint64(amount) * 1000;
+        while (size > 0 && timestamps[first] < cutoff) {
+            dropOldest();
+        }
+    } else {
+        // Unsigned difference, so the sweep counter may wrap
+        while (size > 0 && sweep - sweeps[first] >= quint32(amount)) {
+            dropOldest();
+        }
+    }
+}
+
+void PointCloudItem::dropOldest() {
+    // The point disappears from where it was
+    dirty |= rects[first];
+    first = (first + 1) % rects.size();
+    --size;
+}
+
+void PointCloudItem::clear() {
+    dirty |= bounds;
+    first = 0;
+    size = 0;
+}
+
+QRectF PointCloudItem::flushUpdates() {
+    if (dirty.isNull()) {
+        return QRectF();
+    }
+    QRectF changed = isVisible() ? mapRectToScene(dirty) : QRectF();
+    update(dirty);
+    dirty = QRectF();
+    return changed;
+}
+
+void PointCloudItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) {
+    // Every point looks the same, so ring order does not matter, only the
+    // live part of the ring, which wraps at most once
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(brush);
+    int head = qMin(size, rects.size() - first);
+    painter->drawRects(rects.constData() + first, head);
+    if (head < size) {
+        painter->drawRects(rects.constData(), size - head);
+    }
+}
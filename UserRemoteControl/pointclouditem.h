@@ -0,0 +1,70 @@
+#ifndef POINTCLOUDITEM_H
+#define POINTCLOUDITEM_H
+
+#include <QBrush>
+#include <QGraphicsItem>
+#include <QVector>
+
+// All radar detections as one scene item. Points live in a fixed-capacity
+// ring with their timestamp and sweep number alongside, and paint() draws the
+// whole ring with at most two drawRects() calls. Appending does not touch the
+// scene; flushUpdates() schedules one repaint of just the region that
+// changed since the last call, once per display frame.
+//
+// How long points stay is set by setRetention(): for the last n sweeps or
+// the last n milliseconds. The ring is filled in time order, so expire() only
+// ever drops from the oldest end and costs O(1) per expired point. Capacity
+// is a hard limit on top, once the ring is full the oldest point is
+// overwritten whatever the retention.
+class PointCloudItem : public QGraphicsItem
+{
+public:
+    enum Retention {
+        RetainSweeps,
+        RetainTime
+    };
+
+    explicit PointCloudItem(int capacity, QGraphicsItem *parent = nullptr);
+
+    int capacity() const { return rects.size(); }
+    int count() const { return size; }
+    // Drops all points
+    void setCapacity(int capacity);
+    void setBrush(const QBrush &brush);
+
+    // amount is a number of sweeps, or milliseconds for RetainTime
+    void setRetention(Retention retention, int amount);
+    Retention retention() const { return mode; }
+    int retentionAmount() const { return amount; }
+
+    // timestamp in us, sweep as counted by SweepTracker
+    void append(const QPointF &point, qint64 timestamp, quint32 sweep);
+    // Drops the points that fell out of the retention at time now (us)
+    // during sweep
+    void expire(qint64 now, quint32 sweep);
+    void clear();
+    // Returns the scene rect that changed, null if nothing visible did
+    QRectF flushUpdates();
+
+    QRectF boundingRect() const override { return bounds; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    // 3x3 with a cosmetic outline, as scene->addRect() used to draw them
+    static constexpr qreal PointSize = 4;
+
+    void dropOldest();
+
+    QVector<QRectF> rects;
+    QVector<qint64> timestamps;
+    QVector<quint32> sweeps;
+    int first;  // oldest point
+    int size;
+    Retention mode;
+    int amount;
+    QRectF bounds;
+    QRectF dirty;
+    QBrush brush;
+};
+
+#endif // POINTCLOUDITEM_H
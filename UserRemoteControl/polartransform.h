@@ -0,0 +1,90 @@
+#ifndef POLARTRANSFORM_H
+#define POLARTRANSFORM_H
+
+#include <QPointF>
+#include <QtMath>
+#include <array>
+
+// Radar angle/distance to scene coordinates. The servo only ever reports
+// whole degrees 0-180, so their unit vectors, and those of the needle edges
+// either side, come from tables built at compile time. Fractional angles fall
+// back to qCos/qSin.
+namespace PolarTransform {
+
+const int MaxAngle = 180;
+
+// Half the needle's opening, in radians either side of the beam
+constexpr double NeedleHalfWidth = 0.05;
+
+struct Direction {
+    float cos;
+    float sin;
+};
+
+namespace detail {
+
+constexpr double Pi = 3.14159265358979323846;
+
+// Taylor series, exact to double precision on the [-pi, pi] range used here
+constexpr double sine(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 20; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cosine(double x) {
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 20; ++n) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr std::array<Direction, MaxAngle + 1> makeTable(double offset) {
+    std::array<Direction, MaxAngle + 1> table{};
+    for (int degrees = 0; degrees <= MaxAngle; ++degrees) {
+        double radians = degrees * Pi / 180.0 + offset;
+        table[degrees] = Direction{ float(cosine(radians)), float(sine(radians)) };
+    }
+    return table;
+}
+
+}
+
+inline constexpr std::array<Direction, MaxAngle + 1> Beam = detail::makeTable(0);
+inline constexpr std::array<Direction, MaxAngle + 1> NeedleUpper = detail::makeTable(NeedleHalfWidth);
+inline constexpr std::array<Direction, MaxAngle + 1> NeedleLower = detail::makeTable(-NeedleHalfWidth);
+
+// Unit vector of angle (degrees) turned by offset (radians), taken from table
+// when angle is a whole servo angle
+inline Direction direction(const std::array<Direction, MaxAngle + 1> &table, float angle, double offset) {
+    int whole = int(angle);
+    if (whole == angle && whole >= 0 && whole <= MaxAngle) {
+        return table[whole];
+    }
+    double radians = qDegreesToRadians(double(angle)) + offset;
+    return Direction{ float(qCos(radians)), float(qSin(radians)) };
+}
+
+inline Direction beam(float angle) { return direction(Beam, angle, 0); }
+inline Direction needleUpper(float angle) { return direction(NeedleUpper, angle, NeedleHalfWidth); }
+inline Direction needleLower(float angle) { return direction(NeedleLower, angle, -NeedleHalfWidth); }
+
+// Scene y grows downwards, radar y grows away from the rover
+inline QPointF toScene(const QPointF &origin, const Direction &direction, float distance) {
+    return QPointF(origin.x() + distance * direction.cos, origin.y() - distance * direction.sin);
+}
+
+inline QPointF toScene(const QPointF &origin, float angle, float distance) {
+    return toScene(origin, beam(angle), distance);
+}
+
+}
+
+#endif // POLARTRANSFORM_H
@@ -0,0 +1,108 @@
+#include "ptytransport.h"
+#include <QFile>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+PtyTransport::PtyTransport(const QString &path, QObject *parent)
+    : Transport(parent)
+    , path(path)
+    , fd(-1)
+    , notifier(nullptr)
+{
+}
+
+PtyTransport::~PtyTransport() {
+    close();
+}
+
+#ifdef Q_OS_UNIX
+
+bool PtyTransport::open() {
+    close();
+    fd = ::open(QFile::encodeName(path).constData(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        setErrorString(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+
+    // Raw bytes, no echo or line editing in between
+    termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &Transport::readyRead);
+    return true;
+}
+
+void PtyTransport::close() {
+    delete notifier;
+    notifier = nullptr;
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+qint64 PtyTransport::read(char *data, qint64 maxSize) {
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t count = ::read(fd, data, size_t(maxSize));
+    if (count > 0) {
+        return count;
+    }
+    if (count < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return 0;
+    }
+    // 0 or EIO, the master side was closed
+    setErrorString(count < 0 ? QString::fromLocal8Bit(strerror(errno)) : QString("Hang up"));
+    hangUp();
+    return -1;
+}
+
+qint64 PtyTransport::write(const QByteArray &data) {
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t count = ::write(fd, data.constData(), size_t(data.size()));
+    if (count < 0 && errno != EAGAIN) {
+        setErrorString(QString::fromLocal8Bit(strerror(errno)));
+    }
+    return count;
+}
+
+#else
+
+bool PtyTransport::open() {
+    setErrorString("Pseudo terminals are not supported on this platform");
+    return false;
+}
+
+void PtyTransport::close() {
+}
+
+qint64 PtyTransport::read(char *, qint64) {
+    return -1;
+}
+
+qint64 PtyTransport::write(const QByteArray &) {
+    return -1;
+}
+
+#endif
+
+void PtyTransport::hangUp() {
+    close();
+    // Queued, the reader is still inside read()
+    QMetaObject::invokeMethod(this, &Transport::lost, Qt::QueuedConnection);
+}
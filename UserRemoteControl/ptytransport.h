@@ -0,0 +1,34 @@
+#ifndef PTYTRANSPORT_H
+#define PTYTRANSPORT_H
+
+#include "transport.h"
+
+class QSocketNotifier;
+
+// The slave side of a pseudo terminal, e.g. the one the firmware emulator
+// prints on startup. Read directly with non-blocking I/O, QSerialPort trips
+// over the modem control ioctls a pty does not support. Unix only.
+class PtyTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    explicit PtyTransport(const QString &path, QObject *parent = nullptr);
+    ~PtyTransport();
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return fd >= 0; }
+    qint64 read(char *data, qint64 maxSize) override;
+    qint64 write(const QByteArray &data) override;
+    QString name() const override { return path; }
+
+private:
+    void hangUp();
+
+    QString path;
+    int fd;
+    QSocketNotifier *notifier;
+};
+
+#endif // PTYTRANSPORT_H
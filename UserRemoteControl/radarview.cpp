@@ -0,0 +1,248 @@
+#include "radarview.h"
+#include <QPainter>
+#include <QWheelEvent>
+#include <QtMath>
+
+RadarView::RadarView(QWidget *parent)
+    : QGraphicsView(parent)
+    , shownRange(MaxRange)
+    , levels(LevelCacheSize)
+    , profiler(nullptr)
+    , paintStage(0)
+{
+    setBackgroundBrush(Qt::black);
+    setCacheMode(QGraphicsView::CacheBackground);
+    setViewportUpdateMode(QGraphicsView::NoViewportUpdate);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setRenderHint(QPainter::SmoothPixmapTransform);
+    setOrigin(QPointF());
+}
+
+void RadarView::setOrigin(const QPointF &origin) {
+    radarOrigin = origin;
+
+    // Enough scene to pan across the whole scope at any zoom
+    qreal reach = 2 * MaxRange;
+    setSceneRect(origin.x() - reach, origin.y() - reach, 2 * reach, 1.5 * reach);
+    applyRange();
+    recenter();
+}
+
+void RadarView::setRange(qreal range) {
+    range = qBound(MinRange, range, MaxRange);
+    if (qFuzzyCompare(range, shownRange)) {
+        return;
+    }
+    shownRange = range;
+    applyRange();
+    emit rangeChanged(shownRange);
+}
+
+void RadarView::recenter() {
+    centerOn(radarOrigin.x(), radarOrigin.y() - shownRange / 2);
+}
+
+void RadarView::applyRange() {
+    // The half disc of the range, plus margin, fills the viewport. Logical
+    // pixels; on HiDPI screens Qt scales to device pixels on top.
+    QSize size = viewport()->size();
+    qreal scale = qMin((size.width() - 2 * Margin) / (2 * shownRange),
+                       (size.height() - 2 * Margin) / shownRange);
+    if (scale > 0) {
+        setTransform(QTransform::fromScale(scale, scale));
+        resetCachedContent();
+        viewport()->update();
+    }
+}
+
+void RadarView::markDirty(const QRectF &rect) {
+    if (rect.isNull()) {
+        return;
+    }
+    QRect area = mapFromScene(rect).boundingRect();
+    dirty |= area.adjusted(-DirtyMargin, -DirtyMargin, DirtyMargin, DirtyMargin);
+}
+
+void RadarView::markDirtySector(float fromAngle, float toAngle, qreal radius) {
+    if (fromAngle > toAngle) {
+        qSwap(fromAngle, toAngle);
+    }
+
+    // The wedge grown by the margin on every side: the arc moves out, and
+    // the straight edges move out in parallel, which puts the apex behind
+    // the origin. Past a quarter turn the bounding box costs about the same.
+    qreal margin = DirtyMargin / transform().m11();
+    qreal half = qDegreesToRadians(qMax(qreal(toAngle - fromAngle) / 2, qreal(MinSectorHalfWidth)));
+    qreal bisector = qDegreesToRadians((fromAngle + toAngle) / 2.0);
+    QPointF apex = radarOrigin - QPointF(qCos(bisector), -qSin(bisector)) * (margin / qSin(half));
+
+    // Arc vertices no more than SectorStep apart. The chords cut inside the
+    // arc, so the radius is pushed out to cover it.
+    qreal from = bisector - half;
+    int steps = qMax(1, qCeil(qRadiansToDegrees(2 * half) / SectorStep));
+    qreal step = 2 * half / steps;
+    qreal reach = radius / qCos(step / 2) + margin;
+    sector.resize(0);
+    sector.append(apex);
+    for (int i = 0; i <= steps; ++i) {
+        qreal radians = from + i * step;
+        sector.append(QPointF(radarOrigin.x() + reach * qCos(radians), radarOrigin.y() - reach * qSin(radians)));
+    }
+
+    if (half > M_PI / 4) {
+        dirty |= mapFromScene(sector).boundingRect();
+    } else {
+        // A thin wedge is a stack of short scanlines, far less than its bounding box
+        dirty |= QRegion(mapFromScene(sector));
+    }
+}
+
+qint64 RadarView::flushDirty() {
+    if (dirty.isEmpty()) {
+        return 0;
+    }
+    qint64 area = 0;
+    for (const QRect &rect : dirty) {
+        area += qint64(rect.width()) * rect.height();
+    }
+    viewport()->update(dirty);
+    dirty = QRegion();
+    return area;
+}
+
+void RadarView::scrollContentsBy(int dx, int dy) {
+    // NoViewportUpdate leaves scrolling to us as well
+    QGraphicsView::scrollContentsBy(dx, dy);
+    resetCachedContent();
+    viewport()->update();
+}
+
+QRectF RadarView::scopeRect() const {
+    // The half disc out to the range, labels in the margin around it
+    qreal margin = Margin / transform().m11();
+    return QRectF(radarOrigin.x() - shownRange - margin, radarOrigin.y() - shownRange - margin,
+                  2 * (shownRange + margin), shownRange + 2 * margin);
+}
+
+bool RadarView::event(QEvent *event) {
+    // Moved to a screen with another scale factor
+    if (event->type() == QEvent::DevicePixelRatioChange) {
+        resetCachedContent();
+    }
+    return QGraphicsView::event(event);
+}
+
+void RadarView::drawBackground(QPainter *painter, const QRectF &rect) {
+    painter->fillRect(rect, backgroundBrush());
+
+    qreal scale = transform().m11();
+    qreal ratio = devicePixelRatioF();
+    QString key = QString("%1@%2x%3").arg(shownRange).arg(scale).arg(ratio);
+    QPixmap *cached = levels.object(key);
+    QPixmap level = cached ? *cached : renderScope(scale, ratio);
+    if (!cached) {
+        // The cache owns its copy and deletes it straight away if it is
+        // bigger than the whole cache, so only the local one is drawn
+        int kilobytes = int(qint64(level.width()) * level.height() * level.depth() / 8 / 1024);
+        levels.insert(key, new QPixmap(level), qMax(1, kilobytes));
+    }
+
+    // Same scale it was rendered at, so this is a 1:1 blit
+    painter->drawPixmap(scopeRect(), level, QRectF(level.rect()));
+}
+
+QPixmap RadarView::renderScope(qreal scale, qreal ratio) const {
+    QRectF scope = scopeRect();
+    QSizeF logical = scope.size() * scale;
+    QPixmap pixmap((logical * ratio).toSize());
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+
+    // Logical pixels from here on, with the radar origin at centre
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    QPointF centre = (radarOrigin - scope.topLeft()) * scale;
+    qreal radius = shownRange * scale;
+    QPen pen(QColor(150, 150, 150), 1);
+    pen.setCosmetic(true);
+    painter.setPen(pen);
+
+    // Rings at a round step giving at most five of them
+    qreal step = 500;
+    for (qreal candidate : {5, 10, 20, 25, 50, 100, 200, 500}) {
+        if (shownRange / candidate <= 5) {
+            step = candidate;
+            break;
+        }
+    }
+    QFont font = painter.font();
+    font.setPixelSize(13);
+    painter.setFont(font);
+    QFontMetricsF metrics(font);
+    for (qreal ring = step; ring <= shownRange + 0.5; ring += step) {
+        qreal r = ring * scale;
+        painter.drawArc(QRectF(centre.x() - r, centre.y() - r, 2 * r, 2 * r), 0, 180 * 16);
+        QString label = ring >= 100 ? QString("%1 m").arg(ring / 100) : QString("%1 cm").arg(ring);
+        painter.drawText(QPointF(centre.x() + r - metrics.horizontalAdvance(label) - 2, centre.y() - 3), label);
+    }
+    if (std::fmod(shownRange, step) > 0.5) {
+        painter.drawArc(QRectF(centre.x() - radius, centre.y() - radius, 2 * radius, 2 * radius), 0, 180 * 16);
+    }
+
+    painter.drawLine(QPointF(centre.x() - radius, centre.y()), QPointF(centre.x() + radius, centre.y()));
+    for (int degrees = 0; degrees <= 180; degrees += BearingStep) {
+        qreal radians = qDegreesToRadians(qreal(degrees));
+        QPointF direction(qCos(radians), -qSin(radians));
+        painter.drawLine(centre, centre + direction * radius);
+
+        // Just outside the outer ring, centred on the bearing line
+        QString label = QString("%1°").arg(degrees);
+        QPointF anchor = centre + direction * (radius + metrics.height() * 0.8);
+        QRectF box(QPointF(0, 0), QSizeF(metrics.horizontalAdvance(label), metrics.height()));
+        box.moveCenter(anchor);
+        box.moveBottom(qMin(box.bottom(), centre.y() + Margin));
+        painter.setPen(QColor(220, 220, 220));
+        painter.drawText(box, Qt::AlignCenter, label);
+        painter.setPen(pen);
+    }
+    return pixmap;
+}
+
+void RadarView::setProfiler(FrameProfiler *profiler, int stage) {
+    this->profiler = profiler;
+    paintStage = stage;
+}
+
+void RadarView::paintEvent(QPaintEvent *event) {
+    if (!profiler) {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+    FrameProfiler::Scope scope(*profiler, paintStage);
+    QGraphicsView::paintEvent(event);
+}
+
+void RadarView::resizeEvent(QResizeEvent *event) {
+    QGraphicsView::resizeEvent(event);
+    applyRange();
+    recenter();
+}
+
+void RadarView::wheelEvent(QWheelEvent *event) {
+    // One notch is 120, touchpads send less at a time
+    qreal notches = event->angleDelta().y() / 120.0;
+    if (notches == 0) {
+        return;
+    }
+    setRange(shownRange / qPow(WheelStep, notches));
+    event->accept();
+}
+
+void RadarView::mouseDoubleClickEvent(QMouseEvent *event) {
+    recenter();
+    event->accept();
+}
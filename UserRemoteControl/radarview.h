@@ -0,0 +1,95 @@
+#ifndef RADARVIEW_H
+#define RADARVIEW_H
+
+#include <QCache>
+#include <QGraphicsView>
+#include <QPixmap>
+#include "frameprofiler.h"
+
+// The radar scope, promoted from a plain QGraphicsView in mainwindow.ui.
+//
+// Scene coordinates are centimetres around the radar origin and never
+// change, so samples are converted once when they arrive. Range, zoom and
+// pan only replace the view transform, which Qt then applies to everything
+// it paints; items and their cached geometry are left alone. The range is
+// the distance shown from the origin to the edge of the scope: the wheel
+// zooms around the cursor, dragging pans and a double click re-centres.
+//
+// The scope itself (range rings, bearing lines, labels) is drawn in
+// drawBackground() for the current range and device pixel ratio, into one
+// pixmap per zoom level that is kept for when the view returns to it. On
+// top of that QGraphicsView::CacheBackground keeps the viewport's
+// background, so redrawing items never touches the scope.
+//
+// Scene changes do not repaint the viewport by themselves
+// (NoViewportUpdate). Once per frame the owner reports what changed, as
+// scene rects and as angular sectors from the origin such as the wedge the
+// needle swept, and flushDirty() repaints just that region. The fill cost
+// of a frame then follows what changed, not the window size. Zoom, pan and
+// resize still repaint everything.
+//
+// Repaints are timed into a FrameProfiler stage when one is set.
+class RadarView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    static constexpr qreal MinRange = 50;   // cm
+    static constexpr qreal MaxRange = 400;  // cm, HC-SR04 limit
+
+    explicit RadarView(QWidget *parent = nullptr);
+
+    void setOrigin(const QPointF &origin);
+    QPointF origin() const { return radarOrigin; }
+    qreal range() const { return shownRange; }
+
+    void setProfiler(FrameProfiler *profiler, int stage);
+
+    // Scene rect to repaint on the next flushDirty(), null rects are ignored
+    void markDirty(const QRectF &rect);
+    // The wedge between two radar angles (degrees) out to radius (cm)
+    void markDirtySector(float fromAngle, float toAngle, qreal radius);
+    // Repaints what was marked since the last call, returns its area in pixels
+    qint64 flushDirty();
+
+public slots:
+    void setRange(qreal range);
+    void recenter();
+
+signals:
+    void rangeChanged(qreal range);
+
+protected:
+    bool event(QEvent *event) override;
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    // Room around the scope for the labels, in logical pixels
+    static constexpr qreal Margin = 32;
+    static constexpr qreal WheelStep = 1.15;
+    static const int BearingStep = 15;  // degrees
+    static const int LevelCacheSize = 32 * 1024;  // KB
+    static const int SectorStep = 5;  // degrees between arc vertices of a dirty sector
+    static constexpr qreal MinSectorHalfWidth = 0.5;  // degrees
+    // Antialiased edges and cosmetic pens reach past the scene rect
+    static const int DirtyMargin = 2;  // pixels
+
+    void applyRange();
+    QRectF scopeRect() const;
+    QPixmap renderScope(qreal scale, qreal ratio) const;
+
+    QPointF radarOrigin;
+    qreal shownRange;
+    QCache<QString, QPixmap> levels;
+    QRegion dirty;
+    QPolygonF sector;
+    FrameProfiler *profiler;
+    int paintStage;
+};
+
+#endif // RADARVIEW_H
@@ -0,0 +1,63 @@
+#include "replaytransport.h"
+
+ReplayTransport::ReplayTransport(const QString &path, qint64 bytesPerSecond, bool loop, QObject *parent)
+    : Transport(parent)
+    , file(path)
+    , timer(new QTimer(this))
+    , bytesPerSecond(qMax<qint64>(0, bytesPerSecond))
+    , loop(loop)
+    , released(0)
+    , consumed(0)
+{
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &ReplayTransport::tick);
+}
+
+bool ReplayTransport::open() {
+    close();
+    if (!file.open(QIODevice::ReadOnly)) {
+        setErrorString(file.errorString());
+        return false;
+    }
+    released = 0;
+    consumed = 0;
+    clock.start();
+    timer->start(bytesPerSecond ? TickInterval : 0);
+    return true;
+}
+
+void ReplayTransport::close() {
+    timer->stop();
+    file.close();
+}
+
+void ReplayTransport::tick() {
+    if (bytesPerSecond) {
+        released = clock.nsecsElapsed() * bytesPerSecond / 1000000000;
+    } else {
+        released = consumed + UnthrottledChunk;
+    }
+    if (released > consumed) {
+        emit readyRead();
+    }
+}
+
+qint64 ReplayTransport::read(char *data, qint64 maxSize) {
+    if (!file.isOpen()) {
+        return -1;
+    }
+    qint64 count = file.read(data, qMin(maxSize, released - consumed));
+    if (count <= 0 && file.atEnd()) {
+        if (!loop) {
+            // Stays open and quiet, like a board that stopped talking
+            timer->stop();
+            return 0;
+        }
+        file.seek(0);
+        count = file.read(data, qMin(maxSize, released - consumed));
+    }
+    if (count > 0) {
+        consumed += count;
+    }
+    return qMax<qint64>(count, 0);
+}
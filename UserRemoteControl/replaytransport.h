@@ -0,0 +1,45 @@
+#ifndef REPLAYTRANSPORT_H
+#define REPLAYTRANSPORT_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include "transport.h"
+
+// Plays back raw bytes captured from the port (e.g. cat /dev/ttyACM0 > capture.bin)
+// at a fixed byte rate, so the whole ingest and render path can be driven
+// without hardware. 11520 bytes/s is 115200 baud in real time, 0 replays as
+// fast as the reader keeps up. Commands written to it are discarded.
+class ReplayTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    ReplayTransport(const QString &path, qint64 bytesPerSecond, bool loop, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return file.isOpen(); }
+    qint64 read(char *data, qint64 maxSize) override;
+    qint64 write(const QByteArray &data) override { return data.size(); }
+    QString name() const override { return file.fileName(); }
+
+private slots:
+    void tick();
+
+private:
+    static const int TickInterval = 5;
+    // Bytes handed out per tick when unthrottled, so the device thread still
+    // gets back to its event loop
+    static const qint64 UnthrottledChunk = 64 * 1024;
+
+    QFile file;
+    QTimer *timer;
+    QElapsedTimer clock;
+    qint64 bytesPerSecond;
+    bool loop;
+    qint64 released;  // bytes the rate allows so far
+    qint64 consumed;
+};
+
+#endif // REPLAYTRANSPORT_H
@@ -0,0 +1,56 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QtGlobal>
+#include <vector>
+
+// Fixed-capacity history of values. append() overwrites the oldest once the
+// buffer is full, and any element can be read by age in O(1). Storage is
+// allocated once, up front.
+template <typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(int capacity = 1024)
+        : items(qMax(1, capacity))
+        , next(0)
+        , count(0)
+    {
+    }
+
+    int capacity() const { return int(items.size()); }
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count == capacity(); }
+
+    void append(const T &value) {
+        items[next] = value;
+        next = (next + 1) % capacity();
+        count = qMin(count + 1, capacity());
+    }
+
+    // Forgets the oldest element, its storage is reused later
+    void dropOldest() {
+        if (count > 0) {
+            --count;
+        }
+    }
+
+    void clear() {
+        next = 0;
+        count = 0;
+    }
+
+    // age 0 is the newest element, size() - 1 the oldest
+    const T &newest(int age = 0) const {
+        Q_ASSERT(age >= 0 && age < count);
+        return items[(next - 1 - age + capacity()) % capacity()];
+    }
+
+private:
+    std::vector<T> items;
+    int next;
+    int count;
+};
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,136 @@
+#include "sampleparser.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace SampleParser {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Exactly count comma separated floats, optionally followed by ",<micros>"
+// and ",<sequence>", filling [begin, end)
+bool parseFields(const char *begin, const char *end, float *fields, int count,
+                 quint32 &deviceTime, Telemetry::Message &msg) {
+    const char *p = begin;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            if (p == end || *p != ',') {
+                return false;
+            }
+            ++p;
+        }
+        // from_chars accepts "nan" and "inf", which no sensor reading can be
+        std::from_chars_result result = std::from_chars(p, end, fields[i]);
+        if (result.ec != std::errc() || !std::isfinite(fields[i])) {
+            return false;
+        }
+        p = result.ptr;
+    }
+
+    msg.hasDeviceTime = p != end && *p == ',';
+    deviceTime = 0;
+    if (msg.hasDeviceTime) {
+        std::from_chars_result result = std::from_chars(p + 1, end, deviceTime);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+    }
+
+    msg.hasSequence = msg.hasDeviceTime && p != end && *p == ',';
+    msg.sequence = 0;
+    if (msg.hasSequence) {
+        std::from_chars_result result = std::from_chars(p + 1, end, msg.sequence);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+    }
+    return p == end;
+}
+
+bool equals(const char *begin, const char *end, const char *literal) {
+    size_t length = strlen(literal);
+    return size_t(end - begin) == length && memcmp(begin, literal, length) == 0;
+}
+
+}
+
+bool parseRadarLine(const char *begin, const char *end, Telemetry::Message &msg) {
+    Telemetry::RadarSample &sample = msg.radar;
+    float fields[2];
+    if (!parseFields(begin, end, fields, 2, sample.deviceTime, msg)) {
+        return false;
+    }
+    sample.angle = fields[0];
+    sample.distance = fields[1];
+    sample.timestamp = 0;
+    return true;
+}
+
+bool parseBatteryLine(const char *begin, const char *end, Telemetry::Message &msg) {
+    if (end - begin < 2 || begin[0] != 'B' || begin[1] != ',') {
+        return false;
+    }
+    Telemetry::BatterySample &sample = msg.battery;
+    float fields[5];
+    if (!parseFields(begin + 2, end, fields, 5, sample.deviceTime, msg)) {
+        return false;
+    }
+    sample.busVoltage = fields[0];
+    sample.shuntVoltage = fields[1];
+    sample.loadVoltage = fields[2];
+    sample.current = fields[3];
+    sample.power = fields[4];
+    sample.timestamp = 0;
+    return true;
+}
+
+bool parseAckLine(const char *begin, const char *end, quint16 &sequence) {
+    if (end - begin < 4 || memcmp(begin, "ACK,", 4) != 0) {
+        return false;
+    }
+    std::from_chars_result result = std::from_chars(begin + 4, end, sequence);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseLine(const char *begin, const char *end, Telemetry::Message &msg) {
+    while (begin != end && isSpace(*begin)) {
+        ++begin;
+    }
+    while (end != begin && isSpace(end[-1])) {
+        --end;
+    }
+    if (begin == end) {
+        return false;
+    }
+    msg.hasDeviceTime = false;
+    msg.hasSequence = false;
+
+    if (*begin == 'B') {
+        msg.id = Telemetry::BatteryMessage;
+        return parseBatteryLine(begin, end, msg);
+    }
+    if (equals(begin, end, "LASER_ACTIVATED")) {
+        msg.id = Telemetry::LaserMessage;
+        msg.laser = Telemetry::LaserActivated;
+        return true;
+    }
+    if (equals(begin, end, "LASER_DEACTIVATED")) {
+        msg.id = Telemetry::LaserMessage;
+        msg.laser = Telemetry::LaserDeactivated;
+        return true;
+    }
+    if (*begin == 'A') {
+        msg.id = Telemetry::AckMessage;
+        return parseAckLine(begin, end, msg.ack);
+    }
+    msg.id = Telemetry::RadarMessage;
+    return parseRadarLine(begin, end, msg);
+}
+
+}
@@ -0,0 +1,26 @@
+#ifndef SAMPLEPARSER_H
+#define SAMPLEPARSER_H
+
+#include "telemetryprotocol.h"
+
+// ASCII fallback protocol, parsed straight from the receive buffer with
+// std::from_chars. Nothing here touches the heap.
+//
+//   <angle>,<distance>[,<micros>[,<sequence>]]
+//   B,<bus>,<shunt>,<load>,<current>,<power>[,<micros>[,<sequence>]]
+//   LASER_ACTIVATED / LASER_DEACTIVATED
+//   ACK,<sequence>
+namespace SampleParser {
+
+// Fill msg.radar / msg.battery, and hasDeviceTime and hasSequence from the
+// optional trailing fields
+bool parseRadarLine(const char *begin, const char *end, Telemetry::Message &msg);
+bool parseBatteryLine(const char *begin, const char *end, Telemetry::Message &msg);
+bool parseAckLine(const char *begin, const char *end, quint16 &sequence);
+
+// Any of the lines above, surrounding whitespace (the \r of println) is ignored
+bool parseLine(const char *begin, const char *end, Telemetry::Message &msg);
+
+}
+
+#endif // SAMPLEPARSER_H
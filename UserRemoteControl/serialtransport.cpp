@@ -0,0 +1,45 @@
+#include "serialtransport.h"
+
+SerialTransport::SerialTransport(const QString &portName, QObject *parent)
+    : Transport(parent)
+    , port(new QSerialPort(portName, this))
+{
+    connect(port, &QSerialPort::readyRead, this, &Transport::readyRead);
+    connect(port, &QSerialPort::errorOccurred, this, &SerialTransport::handleError);
+}
+
+bool SerialTransport::open() {
+    port->setBaudRate(QSerialPort::Baud115200);
+    port->setDataBits(QSerialPort::Data8);
+    port->setParity(QSerialPort::NoParity);
+    port->setStopBits(QSerialPort::OneStop);
+    port->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!port->open(QIODevice::ReadWrite)) {
+        setErrorString(port->errorString());
+        return false;
+    }
+    return true;
+}
+
+void SerialTransport::close() {
+    port->close();
+}
+
+qint64 SerialTransport::read(char *data, qint64 maxSize) {
+    return port->read(data, maxSize);
+}
+
+qint64 SerialTransport::write(const QByteArray &data) {
+    return port->write(data);
+}
+
+void SerialTransport::handleError(QSerialPort::SerialPortError error) {
+    // ResourceError is what an unplugged or re-enumerating USB device looks like
+    if (error != QSerialPort::ResourceError || !port->isOpen()) {
+        return;
+    }
+    setErrorString(port->errorString());
+    port->close();
+    emit lost();
+}
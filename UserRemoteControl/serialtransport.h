@@ -0,0 +1,29 @@
+#ifndef SERIALTRANSPORT_H
+#define SERIALTRANSPORT_H
+
+#include <QSerialPort>
+#include "transport.h"
+
+// The Arduino's USB serial port at 115200 8N1
+class SerialTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    explicit SerialTransport(const QString &portName, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return port->isOpen(); }
+    qint64 read(char *data, qint64 maxSize) override;
+    qint64 write(const QByteArray &data) override;
+    QString name() const override { return port->portName(); }
+
+private slots:
+    void handleError(QSerialPort::SerialPortError error);
+
+private:
+    QSerialPort *port;
+};
+
+#endif // SERIALTRANSPORT_H
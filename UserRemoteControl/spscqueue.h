@@ -0,0 +1,77 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. push() never blocks: when the consumer falls behind it fails and the
+// caller drops the value, so the producer's latency stays bounded.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(int capacity = 1024)
+        : head(0)
+        , tailCache(0)
+        , tail(0)
+        , headCache(0)
+    {
+        int rounded = 2;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        items.resize(rounded);
+        mask = quint32(rounded - 1);
+    }
+
+    int capacity() const { return int(mask + 1); }
+
+    // Approximate when called from a third thread
+    int size() const {
+        return int(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+    }
+
+    // Producer side
+    bool push(const T &value) {
+        const quint32 t = tail.load(std::memory_order_relaxed);
+        if (t - headCache > mask) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache > mask) {
+                return false;
+            }
+        }
+        items[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &value) {
+        const quint32 h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) {
+                return false;
+            }
+        }
+        value = items[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    Q_DISABLE_COPY(SpscQueue)
+
+    std::vector<T> items;
+    quint32 mask;
+
+    // Consumer and producer state live on separate cache lines
+    alignas(64) std::atomic<quint32> head;
+    quint32 tailCache;
+    alignas(64) std::atomic<quint32> tail;
+    quint32 headCache;
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,110 @@
+#include "sweepcontouritem.h"
+#include <QPainter>
+#include "polartransform.h"
+
+SweepContourItem::SweepContourItem(const QPointF &origin, qreal maxRange, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , origin(origin)
+    , maxRange(maxRange)
+    , sweep(0)
+    , lastAngle(0)
+    , empty(true)
+    , color(Qt::red)
+    , filled(false)
+{
+    qreal reach = maxRange + PenWidth;
+    bounds = QRectF(origin.x() - reach, origin.y() - reach, 2 * reach, reach + PenWidth);
+    clear();
+}
+
+void SweepContourItem::setColor(const QColor &color) {
+    this->color = color;
+    update();
+}
+
+void SweepContourItem::setFilled(bool filled) {
+    this->filled = filled;
+    update();
+}
+
+void SweepContourItem::addSample(float angle, float distance, quint32 sweep) {
+    // Keeps every vertex inside bounds, so repaints never leave stale lines behind
+    if (distance <= 0 || distance > maxRange) {
+        distance = float(maxRange);
+    }
+    QPointF point = PolarTransform::toScene(origin, angle, distance);
+
+    if (empty) {
+        current.lineTo(point);
+        dirty |= segment(origin, point);
+    } else if (sweep != this->sweep) {
+        // Turned around: the finished sweep moves back, the new one starts
+        // from the turning point so the outline has no gap
+        previous.swap(current);
+        current.clear();
+        current.moveTo(origin);
+        current.lineTo(lastPoint);
+        current.lineTo(point);
+        dirty = bounds;
+    } else if (angle == lastAngle) {
+        // The servo held still, e.g. for the laser: move the vertex, don't add one
+        QPointF before = current.elementAt(current.elementCount() - 2);
+        current.setElementPositionAt(current.elementCount() - 1, point.x(), point.y());
+        dirty |= segment(before, lastPoint) | segment(before, point);
+    } else {
+        current.lineTo(point);
+        dirty |= segment(lastPoint, point);
+    }
+
+    this->sweep = sweep;
+    lastAngle = angle;
+    lastPoint = point;
+    empty = false;
+}
+
+void SweepContourItem::clear() {
+    current.clear();
+    previous.clear();
+    current.moveTo(origin);
+    empty = true;
+    dirty = bounds;
+}
+
+QRectF SweepContourItem::flushUpdates() {
+    if (dirty.isNull()) {
+        return QRectF();
+    }
+    QRectF changed = isVisible() ? mapRectToScene(dirty) : QRectF();
+    update(dirty);
+    dirty = QRectF();
+    return changed;
+}
+
+QRectF SweepContourItem::segment(const QPointF &from, const QPointF &to) const {
+    // Filled, the wedge back to the origin changes too. Taken in edge by
+    // edge, a union with an empty rect at the origin would be a no-op.
+    QRectF rect = QRectF(from, to).normalized();
+    if (filled) {
+        rect.setLeft(qMin(rect.left(), origin.x()));
+        rect.setRight(qMax(rect.right(), origin.x()));
+        rect.setTop(qMin(rect.top(), origin.y()));
+        rect.setBottom(qMax(rect.bottom(), origin.y()));
+    }
+    return rect.adjusted(-PenWidth, -PenWidth, PenWidth, PenWidth);
+}
+
+void SweepContourItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) {
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QColor faint = color;
+    faint.setAlpha(filled ? 40 : 90);
+    painter->setPen(QPen(faint, PenWidth));
+    painter->setBrush(filled ? QBrush(faint) : Qt::NoBrush);
+    painter->drawPath(previous);
+
+    QColor strong = color;
+    strong.setAlpha(filled ? 90 : 255);
+    painter->setPen(QPen(color, PenWidth));
+    painter->setBrush(filled ? QBrush(strong) : Qt::NoBrush);
+    painter->drawPath(current);
+}
@@ -0,0 +1,51 @@
+#ifndef SWEEPCONTOURITEM_H
+#define SWEEPCONTOURITEM_H
+
+#include <QGraphicsItem>
+#include <QPainterPath>
+
+// Range against angle as one outline per sweep instead of one dot per
+// sample. The sweep in progress grows a QPainterPath a vertex at a time, the
+// sweep before it stays on screen, fainter, until the next one completes.
+// Both paths start at the radar origin, so filled they are the area the
+// radar saw as free. The two paths are swapped and cleared at every turn,
+// which keeps their storage, so nothing is allocated once the first sweeps
+// are in.
+class SweepContourItem : public QGraphicsItem
+{
+public:
+    explicit SweepContourItem(const QPointF &origin, qreal maxRange = 400, QGraphicsItem *parent = nullptr);
+
+    void setColor(const QColor &color);
+    void setFilled(bool filled);
+
+    // sweep as counted by SweepTracker. No echo (distance <= 0 or beyond
+    // maxRange) draws the outline at maxRange, everything up to it was free
+    void addSample(float angle, float distance, quint32 sweep);
+    void clear();
+    // Returns the scene rect that changed, null if nothing visible did
+    QRectF flushUpdates();
+
+    QRectF boundingRect() const override { return bounds; }
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    static constexpr qreal PenWidth = 2;
+
+    QRectF segment(const QPointF &from, const QPointF &to) const;
+
+    QPointF origin;
+    qreal maxRange;
+    QRectF bounds;
+    QPainterPath current;
+    QPainterPath previous;
+    quint32 sweep;
+    float lastAngle;
+    QPointF lastPoint;
+    bool empty;
+    QRectF dirty;
+    QColor color;
+    bool filled;
+};
+
+#endif // SWEEPCONTOURITEM_H
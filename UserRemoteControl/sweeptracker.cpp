@@ -0,0 +1,25 @@
+#include "sweeptracker.h"
+
+SweepTracker::SweepTracker() {
+    reset();
+}
+
+void SweepTracker::reset() {
+    lastAngle = 0;
+    direction = 0;
+    sweep = 0;
+    started = false;
+}
+
+quint32 SweepTracker::update(float angle) {
+    if (started && angle != lastAngle) {
+        int step = angle > lastAngle ? 1 : -1;
+        if (direction != 0 && step != direction) {
+            ++sweep;
+        }
+        direction = step;
+    }
+    started = true;
+    lastAngle = angle;
+    return sweep;
+}
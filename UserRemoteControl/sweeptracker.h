@@ -0,0 +1,27 @@
+#ifndef SWEEPTRACKER_H
+#define SWEEPTRACKER_H
+
+#include <QtGlobal>
+
+// Numbers the servo sweeps. A new sweep starts whenever the angle turns
+// around (at 0 and 180 in AUTO, or on a manual move the other way).
+// Repeated angles, e.g. while the servo holds for the laser, do not count.
+class SweepTracker
+{
+public:
+    SweepTracker();
+
+    void reset();
+
+    // Feeds the next sample's angle, returns its sweep number
+    quint32 update(float angle);
+    quint32 current() const { return sweep; }
+
+private:
+    float lastAngle;
+    int direction;  // +1 up, -1 down, 0 unknown
+    quint32 sweep;
+    bool started;
+};
+
+#endif // SWEEPTRACKER_H
@@ -0,0 +1,41 @@
+#include "tcptransport.h"
+#include <QSignalBlocker>
+
+TcpTransport::TcpTransport(const QString &host, quint16 port, QObject *parent)
+    : Transport(parent)
+    , socket(new QTcpSocket(this))
+    , host(host.isEmpty() ? QString("127.0.0.1") : host)
+    , port(port)
+{
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(socket, &QTcpSocket::readyRead, this, &Transport::readyRead);
+    connect(socket, &QTcpSocket::disconnected, this, &Transport::lost);
+}
+
+bool TcpTransport::open() {
+    socket->connectToHost(host, port);
+    if (!socket->waitForConnected(ConnectTimeout)) {
+        setErrorString(socket->errorString());
+        socket->abort();
+        return false;
+    }
+    return true;
+}
+
+void TcpTransport::close() {
+    // Closing on purpose is not a loss, keep abort() from emitting disconnected
+    const QSignalBlocker blocker(socket);
+    socket->abort();
+}
+
+qint64 TcpTransport::read(char *data, qint64 maxSize) {
+    return socket->read(data, maxSize);
+}
+
+qint64 TcpTransport::write(const QByteArray &data) {
+    return socket->write(data);
+}
+
+QString TcpTransport::name() const {
+    return QString("%1:%2").arg(host).arg(port);
+}
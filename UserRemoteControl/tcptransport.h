@@ -0,0 +1,30 @@
+#ifndef TCPTRANSPORT_H
+#define TCPTRANSPORT_H
+
+#include <QTcpSocket>
+#include "transport.h"
+
+// TCP client, e.g. to a serial-to-network bridge or the emulator on localhost
+class TcpTransport : public Transport
+{
+    Q_OBJECT
+
+public:
+    TcpTransport(const QString &host, quint16 port, QObject *parent = nullptr);
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return socket->state() == QAbstractSocket::ConnectedState; }
+    qint64 read(char *data, qint64 maxSize) override;
+    qint64 write(const QByteArray &data) override;
+    QString name() const override;
+
+private:
+    static const int ConnectTimeout = 1000;
+
+    QTcpSocket *socket;
+    QString host;
+    quint16 port;
+};
+
+#endif // TCPTRANSPORT_H
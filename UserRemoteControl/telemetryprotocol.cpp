@@ -0,0 +1,173 @@
+#include "telemetryprotocol.h"
+#include <QtEndian>
+
+namespace Telemetry {
+
+namespace {
+
+const int RadarPayloadSize = 7;
+const int BatteryPayloadSize = 12;
+const int LaserPayloadSize = 1;
+const int AckPayloadSize = 2;
+const int HeaderSize = 3;
+const int CrcSize = 2;
+
+int payloadSize(quint8 id) {
+    switch (id) {
+    case RadarMessage:
+        return RadarPayloadSize;
+    case BatteryMessage:
+        return BatteryPayloadSize;
+    case LaserMessage:
+        return LaserPayloadSize;
+    case AckMessage:
+        return AckPayloadSize;
+    }
+    return -1;
+}
+
+}
+
+int cobsEncode(const char *in, int size, char *out) {
+    int codeIndex = 0;
+    int o = 1;
+    quint8 code = 1;
+
+    for (int i = 0; i < size; ++i) {
+        if (in[i] == 0) {
+            out[codeIndex] = char(code);
+            codeIndex = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFF) {
+                out[codeIndex] = char(code);
+                codeIndex = o++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = char(code);
+    return o;
+}
+
+int cobsDecode(const char *in, int size, char *out) {
+    int i = 0;
+    int o = 0;
+
+    while (i < size) {
+        quint8 code = quint8(in[i++]);
+        if (code == 0 || i + code - 1 > size) {
+            return -1;
+        }
+        for (int k = 1; k < code; ++k) {
+            out[o++] = in[i++];
+        }
+        if (code < 0xFF && i < size) {
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+bool decodeFrame(const char *encoded, int size, Message &msg, DecodeError *error) {
+    DecodeError dummy;
+    if (!error) {
+        error = &dummy;
+    }
+    *error = FramingError;
+
+    if (size < 2 || size > MaxFrameSize) {
+        return false;
+    }
+
+    char raw[MaxFrameSize];
+    int length = cobsDecode(encoded, size, raw);
+    if (length < HeaderSize + CrcSize) {
+        return false;
+    }
+
+    int bodySize = length - CrcSize;
+    quint16 crc = qFromLittleEndian<quint16>(raw + bodySize);
+    if (crc != qChecksum(QByteArrayView(raw, bodySize))) {
+        *error = CrcError;
+        return false;
+    }
+
+    quint8 id = quint8(raw[0]);
+    if (payloadSize(id) != bodySize - HeaderSize) {
+        return false;
+    }
+    *error = NoDecodeError;
+
+    const char *p = raw + HeaderSize;
+    msg.id = MessageId(id);
+    msg.hasDeviceTime = false;
+    msg.hasSequence = true;
+    msg.sequence = qFromLittleEndian<quint16>(raw + 1);
+    switch (msg.id) {
+    case RadarMessage:
+        msg.radar.angle = quint8(p[0]);
+        msg.radar.distance = qFromLittleEndian<quint16>(p + 1) / 10.0f;
+        msg.radar.deviceTime = qFromLittleEndian<quint32>(p + 3);
+        msg.radar.timestamp = 0;
+        msg.hasDeviceTime = true;
+        break;
+    case BatteryMessage:
+        msg.battery.busVoltage = qFromLittleEndian<qint16>(p) / 1000.0f;
+        msg.battery.shuntVoltage = qFromLittleEndian<qint16>(p + 2) / 100.0f;
+        msg.battery.loadVoltage = msg.battery.busVoltage + msg.battery.shuntVoltage / 1000.0f;
+        msg.battery.current = qFromLittleEndian<qint16>(p + 4) / 10.0f;
+        msg.battery.power = qFromLittleEndian<quint16>(p + 6);
+        msg.battery.deviceTime = qFromLittleEndian<quint32>(p + 8);
+        msg.battery.timestamp = 0;
+        msg.hasDeviceTime = true;
+        break;
+    case LaserMessage:
+        msg.laser = quint8(p[0]) ? LaserActivated : LaserDeactivated;
+        break;
+    case AckMessage:
+        msg.ack = qFromLittleEndian<quint16>(p);
+        break;
+    }
+    return true;
+}
+
+QByteArray encodeFrame(const Message &msg) {
+    char raw[MaxFrameSize];
+    char *p = raw + HeaderSize;
+    raw[0] = char(msg.id);
+    qToLittleEndian<quint16>(msg.hasSequence ? msg.sequence : 0, raw + 1);
+
+    switch (msg.id) {
+    case RadarMessage:
+        p[0] = char(qBound(0, qRound(msg.radar.angle), 255));
+        qToLittleEndian<quint16>(quint16(qBound(0, qRound(msg.radar.distance * 10.0f), 0xFFFF)), p + 1);
+        qToLittleEndian<quint32>(msg.radar.deviceTime, p + 3);
+        break;
+    case BatteryMessage:
+        qToLittleEndian<qint16>(qint16(qRound(msg.battery.busVoltage * 1000.0f)), p);
+        qToLittleEndian<qint16>(qint16(qRound(msg.battery.shuntVoltage * 100.0f)), p + 2);
+        qToLittleEndian<qint16>(qint16(qRound(msg.battery.current * 10.0f)), p + 4);
+        qToLittleEndian<quint16>(quint16(qBound(0, qRound(msg.battery.power), 0xFFFF)), p + 6);
+        qToLittleEndian<quint32>(msg.battery.deviceTime, p + 8);
+        break;
+    case LaserMessage:
+        p[0] = char(msg.laser);
+        break;
+    case AckMessage:
+        qToLittleEndian<quint16>(msg.ack, p);
+        break;
+    }
+
+    int bodySize = HeaderSize + payloadSize(msg.id);
+    qToLittleEndian<quint16>(qChecksum(QByteArrayView(raw, bodySize)), raw + bodySize);
+
+    QByteArray frame(bodySize + CrcSize + 2, Qt::Uninitialized);
+    int length = cobsEncode(raw, bodySize + CrcSize, frame.data());
+    frame[length] = 0;
+    frame.resize(length + 1);
+    return frame;
+}
+
+}
@@ -0,0 +1,96 @@
+#ifndef TELEMETRYPROTOCOL_H
+#define TELEMETRYPROTOCOL_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Binary telemetry spoken by autonomousroverdashboard.ino (TELEMETRY_BINARY).
+//
+// Frame on the wire: COBS(id | sequence | payload | crc16) 0x00
+//   - sequence is a u16 counted per message id, gaps are lost frames
+//   - crc16 is CRC-16/X-25 over id + sequence + payload, little endian
+//     (qChecksum on the host, _crc_ccitt_update on the AVR)
+//   - all multi-byte payload fields are little endian
+//
+//   RadarMessage    u8 angle (deg), u16 distance (mm), u32 micros
+//   BatteryMessage  i16 bus (mV), i16 shunt (10 uV), i16 current (0.1 mA), u16 power (mW), u32 micros
+//   LaserMessage    u8 state (LaserState)
+//   AckMessage      u16 sequence of the applied "<seq>:<command>" line
+namespace Telemetry {
+
+enum MessageId : quint8 {
+    RadarMessage = 0x01,
+    BatteryMessage = 0x02,
+    LaserMessage = 0x03,
+    AckMessage = 0x04
+};
+
+enum LaserState : quint8 {
+    LaserDeactivated = 0,
+    LaserActivated = 1
+};
+
+// AutoDetectFraming starts on the ASCII lines and switches to binary on the
+// first 0x00 delimiter, which the ASCII protocol never sends.
+enum Framing {
+    AutoDetectFraming,
+    AsciiFraming,
+    BinaryFraming
+};
+
+// Largest encoded frame we accept before the 0x00 delimiter
+const int MaxFrameSize = 64;
+
+enum DecodeError {
+    NoDecodeError,
+    FramingError,  // bad COBS, wrong length or unknown id
+    CrcError
+};
+
+// deviceTime is the firmware's micros() when the sample was taken, timestamp
+// the same instant on the host clock (us since epoch), see ClockSync
+struct RadarSample {
+    float angle;     // deg
+    float distance;  // cm
+    quint32 deviceTime;
+    qint64 timestamp;
+};
+
+struct BatterySample {
+    float busVoltage;    // V
+    float shuntVoltage;  // mV
+    float loadVoltage;   // V
+    float current;       // mA
+    float power;         // mW
+    quint32 deviceTime;
+    qint64 timestamp;
+};
+
+struct Message {
+    MessageId id;
+    bool hasDeviceTime;  // false for ASCII lines from firmware without timestamps
+    bool hasSequence;    // false for ASCII lines from firmware without sequence numbers
+    quint16 sequence;
+    union {
+        RadarSample radar;
+        BatterySample battery;
+        LaserState laser;
+        quint16 ack;
+    };
+};
+
+// Both return the number of bytes written to out, cobsDecode returns -1 on a
+// malformed block. cobsEncode needs size + size / 254 + 1 bytes of room.
+int cobsEncode(const char *in, int size, char *out);
+int cobsDecode(const char *in, int size, char *out);
+
+// Decodes one frame without its trailing 0x00. Fails on COBS, CRC or length
+// errors, error (if given) tells which.
+bool decodeFrame(const char *encoded, int size, Message &msg, DecodeError *error = nullptr);
+
+// Encoded frame including the trailing 0x00
+QByteArray encodeFrame(const Message &msg);
+
+}
+
+#endif // TELEMETRYPROTOCOL_H
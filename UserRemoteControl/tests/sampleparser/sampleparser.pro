@@ -0,0 +1,14 @@
+QT       = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../sampleparser.cpp \
+    tst_sampleparser.cpp
+
+HEADERS += \
+    ../../sampleparser.h \
+    ../../telemetryprotocol.h
@@ -0,0 +1,133 @@
+#include "sampleparser.h"
+#include <QTest>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// Global operator new counts while a test has switched it on
+bool countAllocations = false;
+int allocations = 0;
+
+bool parse(const char *line, Telemetry::Message &msg) {
+    return SampleParser::parseLine(line, line + strlen(line), msg);
+}
+
+}
+
+void *operator new(std::size_t size) {
+    if (countAllocations) {
+        ++allocations;
+    }
+    if (void *p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    free(p);
+}
+
+class TestSampleParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void radarLine();
+    void batteryLine();
+    void eventLines();
+    void rejectsBadFields_data();
+    void rejectsBadFields();
+    void noAllocations();
+};
+
+void TestSampleParser::radarLine() {
+    Telemetry::Message msg;
+    QVERIFY(parse("90,42.5\r", msg));
+    QVERIFY(msg.id == Telemetry::RadarMessage);
+    QCOMPARE(msg.radar.angle, 90.0f);
+    QCOMPARE(msg.radar.distance, 42.5f);
+    QVERIFY(!msg.hasDeviceTime);
+    QVERIFY(!msg.hasSequence);
+
+    QVERIFY(parse("12,300,4294967295,65535", msg));
+    QVERIFY(msg.hasDeviceTime);
+    QVERIFY(msg.hasSequence);
+    QCOMPARE(msg.radar.deviceTime, quint32(4294967295u));
+    QCOMPARE(msg.sequence, quint16(65535));
+}
+
+void TestSampleParser::batteryLine() {
+    Telemetry::Message msg;
+    QVERIFY(parse("B,7.4,1.2,7.41,120.5,893,1000,7", msg));
+    QVERIFY(msg.id == Telemetry::BatteryMessage);
+    QCOMPARE(msg.battery.busVoltage, 7.4f);
+    QCOMPARE(msg.battery.power, 893.0f);
+    QCOMPARE(msg.battery.deviceTime, quint32(1000));
+    QCOMPARE(msg.sequence, quint16(7));
+}
+
+void TestSampleParser::eventLines() {
+    Telemetry::Message msg;
+    QVERIFY(parse("LASER_ACTIVATED\r", msg));
+    QVERIFY(msg.id == Telemetry::LaserMessage);
+    QVERIFY(msg.laser == Telemetry::LaserActivated);
+    QVERIFY(parse("LASER_DEACTIVATED", msg));
+    QVERIFY(msg.laser == Telemetry::LaserDeactivated);
+    QVERIFY(parse("ACK,513", msg));
+    QVERIFY(msg.id == Telemetry::AckMessage);
+    QCOMPARE(msg.ack, quint16(513));
+}
+
+void TestSampleParser::rejectsBadFields_data() {
+    QTest::addColumn<QByteArray>("line");
+    QTest::newRow("not a number") << QByteArray("90,ovf");
+    QTest::newRow("overflow") << QByteArray("90,1e40");
+    QTest::newRow("nan") << QByteArray("90,nan");
+    QTest::newRow("inf") << QByteArray("inf,20");
+    QTest::newRow("negative inf") << QByteArray("B,7.4,1.2,-inf,120.5,893");
+    QTest::newRow("missing field") << QByteArray("B,7.4,1.2,7.41,120.5");
+    QTest::newRow("trailing junk") << QByteArray("90,20x");
+    QTest::newRow("bad sequence") << QByteArray("90,20,1000,70000");
+    QTest::newRow("banner") << QByteArray("Rover ready");
+}
+
+void TestSampleParser::rejectsBadFields() {
+    QFETCH(QByteArray, line);
+    Telemetry::Message msg;
+    QVERIFY(!SampleParser::parseLine(line.constData(), line.constData() + line.size(), msg));
+}
+
+void TestSampleParser::noAllocations() {
+    static const char *const lines[] = {
+        "90,42.5,123456,1\r",
+        "B,7.4,1.2,7.41,120.5,893,123456,2\r",
+        "LASER_ACTIVATED\r",
+        "ACK,3\r",
+        "90,ovf\r",
+    };
+    Telemetry::Message msg;
+    int parsed = 0;
+
+    allocations = 0;
+    countAllocations = true;
+    for (int i = 0; i < 10000; ++i) {
+        for (const char *line : lines) {
+            parsed += parse(line, msg) ? 1 : 0;
+        }
+    }
+    countAllocations = false;
+
+    QCOMPARE(parsed, 4 * 10000);
+    QCOMPARE(allocations, 0);
+}
+
+QTEST_APPLESS_MAIN(TestSampleParser)
+
+#include "tst_sampleparser.moc"
@@ -0,0 +1,36 @@
+#include "transport.h"
+#include "ptytransport.h"
+#include "replaytransport.h"
+#include "serialtransport.h"
+#include "tcptransport.h"
+#include <QUrl>
+#include <QUrlQuery>
+
+Transport::Transport(QObject *parent)
+    : QObject(parent)
+{
+}
+
+Transport *Transport::create(const QString &spec, QObject *parent) {
+    // Anything without a known scheme is a serial port name, that includes
+    // Windows drive letters and plain device paths
+    QUrl url(spec);
+    QString scheme = url.scheme();
+
+    if (scheme == "pty") {
+        return new PtyTransport(url.path(), parent);
+    }
+    if (scheme == "tcp") {
+        return new TcpTransport(url.host(), quint16(url.port(5555)), parent);
+    }
+    if (scheme == "replay") {
+        QUrlQuery query(url);
+        qint64 rate = query.hasQueryItem("rate") ? query.queryItemValue("rate").toLongLong() : 11520;
+        bool loop = query.queryItemValue("loop") == "1";
+        return new ReplayTransport(url.path(), rate, loop, parent);
+    }
+    if (scheme == "serial") {
+        return new SerialTransport(url.path(), parent);
+    }
+    return new SerialTransport(spec, parent);
+}
@@ -0,0 +1,49 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <QObject>
+#include <QString>
+
+// Byte stream to the rover. DeviceWorker only talks to this interface, so the
+// same parse path runs on the real board, the emulator or a recording.
+// create() picks the backend from a spec string:
+//
+//   COM9, /dev/ttyACM0, serial:COM9        QSerialPort, 115200 8N1
+//   pty:/dev/pts/3                         pseudo terminal (Unix only)
+//   tcp://127.0.0.1:5555                   TCP socket
+//   replay:capture.bin?rate=11520&loop=1   recorded bytes at rate bytes/s,
+//                                          rate=0 replays as fast as possible
+class Transport : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Transport *create(const QString &spec, QObject *parent = nullptr);
+
+    explicit Transport(QObject *parent = nullptr);
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // Never blocks, returns 0 when nothing is waiting and -1 on error
+    virtual qint64 read(char *data, qint64 maxSize) = 0;
+    virtual qint64 write(const QByteArray &data) = 0;
+
+    // Shown to the user, e.g. the port name
+    virtual QString name() const = 0;
+    QString errorString() const { return errorMessage; }
+
+signals:
+    void readyRead();
+    // The other end went away (unplugged, closed), open() again to retry
+    void lost();
+
+protected:
+    void setErrorString(const QString &message) { errorMessage = message; }
+
+private:
+    QString errorMessage;
+};
+
+#endif // TRANSPORT_H
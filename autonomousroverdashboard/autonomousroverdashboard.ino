@@ -1,6 +1,19 @@
 #include <Servo.h>
 #include <Wire.h>
 #include <Adafruit_INA219.h>
+#include <util/crc16.h>
+
+// 1 = COBS/CRC16 binary frames, 0 = the old ASCII lines.
+// Frame layout must match UserRemoteControl/telemetryprotocol.h
+#define TELEMETRY_BINARY 1
+
+const uint8_t MSG_RADAR = 0x01;
+const uint8_t MSG_BATTERY = 0x02;
+const uint8_t MSG_LASER = 0x03;
+const uint8_t MSG_ACK = 0x04;
+
+// Per channel (message id) sequence numbers, so the host can count lost samples
+uint16_t sequences[MSG_ACK + 1];
 
 // Servo
 Servo myservo;
@@ -8,6 +21,9 @@ Servo myservo;
 // HC-SR04 ultrasonic sensor
 const int trigPin = 9;
 const int echoPin = 10;
+// pulseIn() waits up to 1 s by default. 30 ms is past the 4 m range, and keeps
+// a missing echo from stalling the loop (and every command ack) for a second
+const unsigned long echoTimeout = 30000;
 
 // Laser
 const int laserPin = 12;
@@ -17,6 +33,7 @@ Adafruit_INA219 ina219;
 
 long duration;
 float distance;
+unsigned long distanceTime; // micros() when the ping went out
 int servoSetting;
 bool servoIncreasing = true;
 
@@ -51,20 +68,26 @@ void setup() {
 
 bool laserActive = false;
 unsigned long laserStartTime = 0;
+unsigned long laserStopTime = 0;
 bool autoMode = false;
 bool servoStopped = false;
+// Set by HOST_LASER: the dashboard fires the laser, only for targets that
+// moved. Standalone (and after every reset) anything within 50 cm does.
+bool hostLaser = false;
 
 void loop() {
   getDistance();
   readSerialCommand();
   outputDistance();
 
-  if (distance < 50 && !laserActive) {
+  if (!hostLaser && distance < 50 && !laserActive && !servoStopped) {
     activateLaser();
-    Serial.println("LASER_ACTIVATED");
+    sendLaserEvent(true);
   } else if (laserActive && millis() - laserStartTime >= 2000) {
     deactivateLaser();
-    Serial.println("LASER_DEACTIVATED");
+    sendLaserEvent(false);
+  } else if (!laserActive && servoStopped && millis() - laserStopTime >= 1000) {
+    servoStopped = false; // Tunggu 1 detik sebelum melanjutkan operasi normal
   }
 
   if (!laserActive && !servoStopped) {
@@ -85,11 +108,13 @@ void activateLaser() {
  //  myservo.write(myservo.read()); // Hentikan servo
 }
 
+// The servo stays stopped for another second, timed in loop() so commands keep
+// being read and acked meanwhile
 void deactivateLaser() {
   laserActive = false;
+  servoStopped = true;
+  laserStopTime = millis();
   digitalWrite(laserPin, LOW);
-  delay(1000); // Tunggu 1 detik sebelum melanjutkan operasi normal
-  servoStopped = false;
 }
 
 void updateServoAuto() {
@@ -109,45 +134,165 @@ void updateServoAuto() {
   myservo.write(servoSetting);
 }
 
+// Collect command bytes without blocking, every complete line is handled
+char commandBuffer[24];
+uint8_t commandLength = 0;
+
 void readSerialCommand() {
-  if (Serial.available() > 0) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-
-    if (command == "AUTO") {
-      autoMode = true;
-    } else if (command == "MANUAL") {
-      autoMode = false;
-    } else if (command == "LASER_ON") {
-      activateLaser();
-    } else if (command == "LASER_OFF") {
-      deactivateLaser();
-    } else {
-      int angle = command.toInt();
-      if (angle >= 0 && angle <= 180 && !autoMode) {
-        myservo.write(angle);
-        servoSetting = angle;
-      }
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c == '\n') {
+      commandBuffer[commandLength] = '\0';
+      handleCommand(commandBuffer);
+      commandLength = 0;
+    } else if (commandLength < sizeof(commandBuffer) - 1) {
+      commandBuffer[commandLength++] = c;
     }
   }
 }
 
+// "<seq>:<command>" is acked with seq once applied, a bare "<command>" is not
+void handleCommand(char *line) {
+  long seq = -1;
+  char *colon = strchr(line, ':');
+  if (colon) {
+    *colon = '\0';
+    seq = atol(line);
+    line = colon + 1;
+  }
+
+  String command(line);
+  command.trim();
+
+  if (command == "AUTO") {
+    autoMode = true;
+  } else if (command == "MANUAL") {
+    autoMode = false;
+  } else if (command == "LASER_ON") {
+    activateLaser();
+  } else if (command == "LASER_OFF") {
+    deactivateLaser();
+  } else if (command == "HOST_LASER") {
+    hostLaser = true;
+  } else if (command == "DEVICE_LASER") {
+    hostLaser = false;
+  } else {
+    int angle = command.toInt();
+    if (angle >= 0 && angle <= 180 && !autoMode) {
+      myservo.write(angle);
+      servoSetting = angle;
+    }
+  }
+
+  if (seq >= 0) {
+    sendAck(seq);
+  }
+}
+
+void sendAck(uint16_t seq) {
+#if TELEMETRY_BINARY
+  uint8_t payload[2];
+  putWord(payload, seq);
+  sendFrame(MSG_ACK, payload, sizeof(payload));
+#else
+  Serial.print("ACK,");
+  Serial.println(seq);
+#endif
+}
+
 // Function to get distance from HC-SR04
 void getDistance() {
+  distanceTime = micros();
   digitalWrite(trigPin, LOW);
   delayMicroseconds(2);
   digitalWrite(trigPin, HIGH);
   delayMicroseconds(10);
   digitalWrite(trigPin, LOW);
-  duration = pulseIn(echoPin, HIGH);
+  duration = pulseIn(echoPin, HIGH, echoTimeout);
+  if (duration == 0) {
+    duration = echoTimeout; // No echo, report it as out of range rather than 0 cm
+  }
   distance = duration * 0.034 / 2;
 }
 
+// Send id + sequence + payload + CRC16 as one COBS frame terminated by 0x00
+void sendFrame(uint8_t id, const uint8_t *payload, uint8_t len) {
+  uint8_t raw[20];
+  uint8_t n = 0;
+  uint16_t seq = sequences[id]++;
+  raw[n++] = id;
+  raw[n++] = seq & 0xFF;
+  raw[n++] = seq >> 8;
+  for (uint8_t i = 0; i < len; i++) {
+    raw[n++] = payload[i];
+  }
+
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < n; i++) {
+    crc = _crc_ccitt_update(crc, raw[i]);
+  }
+  crc ^= 0xFFFF;
+  raw[n++] = crc & 0xFF;
+  raw[n++] = crc >> 8;
+
+  // Frames are far below 254 bytes, so a single COBS block is enough
+  uint8_t out[sizeof(raw) + 2];
+  uint8_t codeIndex = 0;
+  uint8_t code = 1;
+  uint8_t o = 1;
+  for (uint8_t i = 0; i < n; i++) {
+    if (raw[i] == 0) {
+      out[codeIndex] = code;
+      codeIndex = o++;
+      code = 1;
+    } else {
+      out[o++] = raw[i];
+      code++;
+    }
+  }
+  out[codeIndex] = code;
+  out[o++] = 0;
+  Serial.write(out, o);
+}
+
+void putWord(uint8_t *p, uint16_t value) {
+  p[0] = value & 0xFF;
+  p[1] = (value >> 8) & 0xFF;
+}
+
+void putLong(uint8_t *p, uint32_t value) {
+  putWord(p, value & 0xFFFF);
+  putWord(p + 2, value >> 16);
+}
+
+void sendLaserEvent(bool activated) {
+#if TELEMETRY_BINARY
+  uint8_t payload[1] = { activated ? 1 : 0 };
+  sendFrame(MSG_LASER, payload, sizeof(payload));
+#else
+  Serial.println(activated ? "LASER_ACTIVATED" : "LASER_DEACTIVATED");
+#endif
+}
+
 // Function to output distance to Serial
 void outputDistance() {
+#if TELEMETRY_BINARY
+  // Distance in mm straight from the echo time, no float math needed
+  unsigned long mm = (unsigned long)duration * 17UL / 100UL;
+  uint8_t payload[7];
+  payload[0] = servoSetting;
+  putWord(payload + 1, mm > 0xFFFF ? 0xFFFF : mm);
+  putLong(payload + 3, distanceTime);
+  sendFrame(MSG_RADAR, payload, sizeof(payload));
+#else
   Serial.print(servoSetting); // Send servo angle
   Serial.print(",");
-  Serial.println(distance);   // Send distance
+  Serial.print(distance);     // Send distance
+  Serial.print(",");
+  Serial.print(distanceTime);
+  Serial.print(",");
+  Serial.println(sequences[MSG_RADAR]++);
+#endif
 }
 
 // Function to monitor battery parameters
@@ -186,10 +331,22 @@ void monitorBattery() {
 }
 
 void sendBatteryData() {
+  unsigned long batteryTime = micros();
   float shuntvoltage = ina219.getShuntVoltage_mV();
   float busvoltage = ina219.getBusVoltage_V();
   float current_mA = ina219.getCurrent_mA();
   float power_mW = ina219.getPower_mW();
+
+#if TELEMETRY_BINARY
+  // Fixed point: mV, 10 uV, 0.1 mA, mW. Load voltage is derived on the host
+  uint8_t payload[12];
+  putWord(payload, (int16_t)(busvoltage * 1000));
+  putWord(payload + 2, (int16_t)(shuntvoltage * 100));
+  putWord(payload + 4, (int16_t)(current_mA * 10));
+  putWord(payload + 6, (uint16_t)power_mW);
+  putLong(payload + 8, batteryTime);
+  sendFrame(MSG_BATTERY, payload, sizeof(payload));
+#else
   float loadvoltage = busvoltage + (shuntvoltage / 1000);
 
   Serial.print("B,");
@@ -201,5 +358,10 @@ void sendBatteryData() {
   Serial.print(",");
   Serial.print(current_mA);
   Serial.print(",");
-  Serial.println(power_mW);
+  Serial.print(power_mW);
+  Serial.print(",");
+  Serial.print(batteryTime);
+  Serial.print(",");
+  Serial.println(sequences[MSG_BATTERY]++);
+#endif
 }
\ No newline at end of file